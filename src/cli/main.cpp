@@ -0,0 +1,268 @@
+// pixiple-cli: headless image pair search.
+//
+// Usage: pixiple-cli [--output FILE] [--cache FILE] [--state FILE]
+//                    [--threads N] [--decode-threads N]
+//                    [--canonical-orientation] [--quantized] [--benchmark]
+//                    [--test] [PATH...]
+//
+// --threads and --decode-threads set the number of comparing and of
+// decoding threads (both default to the number of hardware threads).
+//
+// --cache keeps signatures in FILE (see SignatureCache) and decodes only
+// images not found there, by path with the same size and last write time
+// or by content.
+//
+// --state keeps the images and pairs found in FILE (see ScanState) and, if
+// it is there from an earlier run with the same options, compares only
+// pairs with images new or changed since, taking the other pairs from it.
+// Best with --cache, so that the other images need not be decoded either.
+// Without PATH, writes the pairs kept in FILE as they are, without reading
+// any images.
+//
+// Writes one line per image pair, tab separated: category (visual, time,
+// location or combined), distance and the two image paths. Categories are
+// written in that order, each sorted by distance.
+//
+// --benchmark loads the images once and then compares them both
+// exhaustively and with the faster options, writing their times and the
+// fraction of the exhaustively found pairs that each category still finds
+// (recall) instead of pairs.
+
+#include "../core/core_tests.h"
+#include "../core/decoder.h"
+#include "../core/job.h"
+#include "../core/paths.h"
+#include "../core/scan_state.h"
+#include "../core/score.h"
+#include "../core/signature_cache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+static const char* const category_names[n_categories] {"visual", "time", "location", "combined"};
+
+static int usage() {
+	std::cerr << "usage: pixiple-cli [--output FILE] [--cache FILE] [--state FILE] [--threads N] [--decode-threads N] [--canonical-orientation] [--quantized] [--benchmark] [--test] [PATH...]\n";
+	return 2;
+}
+
+static void write_pairs(
+	std::ostream& os,
+	const std::vector<std::filesystem::path>& paths,
+	const std::vector<std::vector<SignaturePair>>& pair_categories
+) {
+	for (auto c = 0; c < n_categories; c++) {
+		// sorted by the job, and paths are sorted, so in the order of ImagePair
+		for (const auto& p : pair_categories[c])
+			os << category_names[c] << '\t' << p.distance << '\t'
+				<< paths[p.index_1].string() << '\t' << paths[p.index_2].string() << '\n';
+		os.flush();
+	}
+}
+
+// Sets row id of table to the signature of the image at path, with stamp,
+// from cache, by path (in place) or else by content, or else decoded, and
+// then cached by path.
+static void load_signature(
+	const std::filesystem::path& path,
+	const std::optional<FileStamp>& stamp,
+	SignatureCache& cache,
+	ImageTable& table,
+	const std::uint32_t id
+) {
+	if (stamp && cache.find(path, *stamp, table, id))
+		return;
+
+	auto signature = stamp ? cache.find_by_content(path, *stamp) : nullptr;
+	if (!signature)
+		signature = load_signature(path);
+	if (stamp)
+		cache.insert(path, *stamp, *signature);
+	table.set(id, *signature);
+}
+
+// Runs job, optionally with progress on std::cerr. Returns the time taken
+// in seconds.
+static float run(Job& job, const ThreadCounts& n_threads, const bool show_progress = true) {
+	auto start = std::chrono::steady_clock::now();
+
+	std::vector<std::thread> threads;
+	for (auto i = 0u; i < n_threads.decode; i++)
+		threads.push_back(std::thread([&job] { job.decode(); }));
+	for (auto i = 0u; i < n_threads.compare; i++)
+		threads.push_back(std::thread([&job] { job.work(); }));
+
+	while (show_progress && !job.is_completed()) {
+		std::this_thread::sleep_for(100ms);
+		std::cerr << "\r" << std::fixed << std::setprecision(1) << 100 * job.get_progress() << "%" << std::flush;
+	}
+	for (auto& thread : threads)
+		thread.join();
+	// the progress is erased, for what is written next
+	if (show_progress)
+		std::cerr << "\r" << std::string(8, ' ') << "\r";
+
+	return std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void benchmark(std::ostream& os, const std::vector<std::filesystem::path>& paths, const ThreadCounts& n_threads) {
+	std::vector<std::shared_ptr<const Signature>> signatures(paths.size());
+	Job load_job{paths.size(), [&](const std::uint32_t id, ImageTable& table) {
+		signatures[id] = load_signature(paths[id]);
+		table.set(id, *signatures[id]);
+	}};
+	const auto load_time = run(load_job, n_threads);
+	os << "load\t" << load_time << " s\n";
+	auto load = [&](const std::uint32_t id, ImageTable& table) { table.set(id, *signatures[id]); };
+
+	Job exhaustive_job{paths.size(), load};
+	os << "exhaustive\t" << run(exhaustive_job, n_threads, false) << " s\n";
+
+	auto pair_key = [](const SignaturePair& p) { return std::make_pair(std::min(p.index_1, p.index_2), std::max(p.index_1, p.index_2)); };
+	std::vector<std::vector<std::pair<std::uint32_t, std::uint32_t>>> exhaustive_pairs;
+	for (const auto& pairs : exhaustive_job.get_pair_categories()) {
+		exhaustive_pairs.emplace_back();
+		for (const auto& p : pairs)
+			exhaustive_pairs.back().push_back(pair_key(p));
+		std::sort(exhaustive_pairs.back().begin(), exhaustive_pairs.back().end());
+	}
+
+	const std::pair<const char*, CompareOptions> modes[] {
+		{"canonical-orientation", {true, false}},
+		{"quantized", {false, true}},
+		{"canonical-orientation quantized", {true, true}},
+	};
+	for (const auto& [name, options] : modes) {
+		Job job{paths.size(), load, options};
+		os << name << '\t' << run(job, n_threads, false) << " s";
+
+		for (auto c = 0; c < n_categories; c++) {
+			const auto& expected = exhaustive_pairs[c];
+			auto n_found = std::count_if(job.get_pair_categories()[c].begin(), job.get_pair_categories()[c].end(), [&](const SignaturePair& p) {
+				return std::binary_search(expected.begin(), expected.end(), pair_key(p));
+			});
+			os << '\t' << category_names[c] << " recall " << (expected.empty() ? 1.0f : static_cast<float>(n_found) / expected.size())
+				<< " (" << n_found << "/" << expected.size() << ")";
+		}
+		os << '\n';
+	}
+}
+
+int main(int argc, char* argv[]) {
+	std::vector<std::filesystem::path> roots;
+	std::filesystem::path output_path;
+	std::filesystem::path cache_path;
+	std::filesystem::path state_path;
+	auto n_threads = get_default_thread_counts();
+	CompareOptions options;
+	auto run_benchmark = false;
+
+	for (auto i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--test") {
+			core_tests();
+			return 0;
+		} else if (arg == "--output" && i + 1 < argc) {
+			output_path = argv[++i];
+		} else if (arg == "--cache" && i + 1 < argc) {
+			cache_path = argv[++i];
+		} else if (arg == "--state" && i + 1 < argc) {
+			state_path = argv[++i];
+		} else if (arg == "--threads" && i + 1 < argc) {
+			n_threads.compare = std::max(std::atoi(argv[++i]), 1);
+		} else if (arg == "--decode-threads" && i + 1 < argc) {
+			n_threads.decode = std::max(std::atoi(argv[++i]), 1);
+		} else if (arg == "--canonical-orientation") {
+			options.canonical_orientation = true;
+		} else if (arg == "--quantized") {
+			options.quantized = true;
+		} else if (arg == "--benchmark") {
+			run_benchmark = true;
+		} else if (arg.size() > 1 && arg[0] == '-') {
+			return usage();
+		} else {
+			roots.push_back(arg);
+		}
+	}
+	if (roots.empty() && state_path.empty())
+		return usage();
+
+	std::ofstream output_file;
+	if (!output_path.empty()) {
+		output_file.open(output_path);
+		if (!output_file) {
+			std::cerr << "pixiple-cli: cannot open " << output_path.string() << "\n";
+			return 1;
+		}
+	}
+	std::ostream& os = output_path.empty() ? std::cout : output_file;
+
+	if (roots.empty()) {
+		const auto start = std::chrono::steady_clock::now();
+		ScanState state;
+		if (!state.load(state_path)) {
+			std::cerr << "pixiple-cli: cannot read " << state_path.string() << "\n";
+			return 1;
+		}
+		std::cerr << "Loaded " << state.paths.size() << " images in "
+			<< std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count() << " s\n";
+		os << std::setprecision(std::numeric_limits<float>::max_digits10);
+		write_pairs(os, state.paths, state.pair_categories);
+		return os ? 0 : 1;
+	}
+
+	auto paths = find_images(roots);
+	std::cerr << "Processing " << paths.size() << " images\n";
+
+	if (run_benchmark) {
+		benchmark(os, paths, n_threads);
+		return os ? 0 : 1;
+	}
+
+	os << std::setprecision(std::numeric_limits<float>::max_digits10);
+
+	// stamps are taken once, so that images are compared and kept in the
+	// state as they were when loaded, or else found changed next time
+	std::vector<std::optional<FileStamp>> stamps(paths.size());
+	if (!cache_path.empty() || !state_path.empty())
+		std::transform(paths.begin(), paths.end(), stamps.begin(), get_file_stamp);
+
+	SignatureCache cache;
+	if (!cache_path.empty())
+		cache.load(cache_path);
+	ScanState state;
+	ComparedPairs compared;
+	if (!state_path.empty() && state.load(state_path)) {
+		compared = get_compared_pairs(state, paths, stamps, options);
+		const auto n_compared = std::count(compared.images.begin(), compared.images.end(), true);
+		std::cerr << "Comparing " << paths.size() - n_compared << " new or changed images\n";
+	}
+	Job job{paths.size(), [&](const std::uint32_t id, ImageTable& table) {
+		if (cache_path.empty())
+			table.set(id, *load_signature(paths[id]));
+		else
+			load_signature(paths[id], stamps[id], cache, table, id);
+	}, options, std::move(compared)};
+	const auto time = run(job, n_threads);
+	std::cerr << "Processed in " << time << " s\n";
+	if (!cache_path.empty() && !cache.save(cache_path))
+		std::cerr << "pixiple-cli: cannot write " << cache_path.string() << "\n";
+	if (!state_path.empty() && !ScanState{options, paths, stamps, job.get_pair_categories()}.save(state_path))
+		std::cerr << "pixiple-cli: cannot write " << state_path.string() << "\n";
+
+	write_pairs(os, paths, job.get_pair_categories());
+
+	return os ? 0 : 1;
+}
@@ -0,0 +1,133 @@
+#include "candidates.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+
+std::vector<SignaturePair> find_time_pairs(const ImageTable& table) {
+	// all times of all images, by time
+	std::vector<std::pair<ImageTable::TimePoint, std::uint32_t>> times;
+	for (std::uint32_t id = 0; id < table.size(); id++) {
+		if (!table.oks[id])
+			continue;
+		const auto [begin, end] = table.get_metadata_times(id);
+		for (auto t = begin; t != end; t++)
+			times.push_back({*t, id});
+	}
+	std::sort(times.begin(), times.end());
+
+	// pairs of times less than the maximum distance apart, by pair of
+	// images, with the closest first for images with more than one time
+	std::vector<std::pair<std::uint64_t, ImageTable::TimePoint::duration>> durations;
+	std::size_t begin = 0;
+	for (std::size_t i = 0; i < times.size(); i++) {
+		while (times[i].first - times[begin].first >= time_category_max_distance)
+			begin++;
+		for (auto j = begin; j < i; j++) {
+			const auto id_1 = std::min(times[i].second, times[j].second);
+			const auto id_2 = std::max(times[i].second, times[j].second);
+			if (id_1 != id_2)
+				durations.push_back({static_cast<std::uint64_t>(id_1) << 32 | id_2, times[i].first - times[j].first});
+		}
+	}
+	std::sort(durations.begin(), durations.end());
+
+	const auto max_distance = std::chrono::duration<float>(time_category_max_distance).count();
+	std::vector<SignaturePair> pairs;
+	for (std::size_t i = 0; i < durations.size(); i++) {
+		if (i > 0 && durations[i].first == durations[i - 1].first)
+			continue;
+		const auto distance = std::chrono::duration<float>(durations[i].second).count();
+		if (distance < max_distance)
+			pairs.push_back({static_cast<std::uint32_t>(durations[i].first >> 32), static_cast<std::uint32_t>(durations[i].first), distance});
+	}
+
+	return pairs;
+}
+
+std::vector<SignaturePair> find_location_pairs(const ImageTable& table) {
+	// cells a little wider than the chord of the maximum distance, so that
+	// images closer than it are in the same or in neighbouring cells
+	// despite rounding
+	const auto cell_size = 1.01f * 2 * std::sin(location_category_max_distance / (2 * earth_mean_radius));
+	const std::int64_t cell_offset = 1 << 20;
+
+	using Cell = std::array<std::int64_t, 3>;
+	auto get_cell = [&](const Direction& d) {
+		return Cell{
+			static_cast<std::int64_t>(std::floor(d.x / cell_size)),
+			static_cast<std::int64_t>(std::floor(d.y / cell_size)),
+			static_cast<std::int64_t>(std::floor(d.z / cell_size))};
+	};
+	auto get_cell_key = [&](const Cell& c) {
+		return
+			static_cast<std::uint64_t>(c[0] + cell_offset) << 42 |
+			static_cast<std::uint64_t>(c[1] + cell_offset) << 21 |
+			static_cast<std::uint64_t>(c[2] + cell_offset);
+	};
+
+	// all images with a position, by cell and id
+	std::vector<std::pair<std::uint64_t, std::uint32_t>> cells;
+	for (std::uint32_t id = 0; id < table.size(); id++) {
+		const auto& d = table.metadata_directions[id];
+		if (table.oks[id] && (d.x != 0 || d.y != 0 || d.z != 0))
+			cells.push_back({get_cell_key(get_cell(d)), id});
+	}
+	std::sort(cells.begin(), cells.end());
+
+	// each image with the images of higher id in its and the 26
+	// neighbouring cells
+	std::vector<SignaturePair> pairs;
+	for (const auto& [key, id_1] : cells) {
+		const auto& d1 = table.metadata_directions[id_1];
+		const auto cell = get_cell(d1);
+		for (auto dx = -1; dx <= 1; dx++) {
+			for (auto dy = -1; dy <= 1; dy++) {
+				for (auto dz = -1; dz <= 1; dz++) {
+					const auto neighbour_key = get_cell_key({cell[0] + dx, cell[1] + dy, cell[2] + dz});
+					auto i = std::lower_bound(cells.begin(), cells.end(), std::make_pair(neighbour_key, id_1 + 1));
+					for (; i != cells.end() && i->first == neighbour_key; i++) {
+						const auto id_2 = i->second;
+						const auto distance = earth_distance(d1, table.metadata_directions[id_2]);
+						if (distance < location_category_max_distance)
+							pairs.push_back({id_1, id_2, distance});
+					}
+				}
+			}
+		}
+	}
+
+	return pairs;
+}
+
+std::vector<std::pair<std::uint32_t, std::uint32_t>> find_image_id_pairs(const ImageTable& table) {
+	// ids are interned from 1 up, so they index the buckets directly:
+	// bucket_begins[image_id] is the first of its images in ids
+	std::uint32_t max_image_id = 0;
+	for (std::uint32_t id = 0; id < table.size(); id++)
+		if (table.oks[id])
+			max_image_id = std::max(max_image_id, table.metadata_image_ids[id]);
+	std::vector<std::uint32_t> bucket_begins(static_cast<std::size_t>(max_image_id) + 2);
+	for (std::uint32_t id = 0; id < table.size(); id++)
+		if (table.oks[id] && table.metadata_image_ids[id] != 0)
+			bucket_begins[table.metadata_image_ids[id] + 1]++;
+	for (std::size_t b = 1; b < bucket_begins.size(); b++)
+		bucket_begins[b] += bucket_begins[b - 1];
+
+	// images by image id, then by id
+	std::vector<std::uint32_t> ids(bucket_begins.back());
+	auto ends = bucket_begins;
+	for (std::uint32_t id = 0; id < table.size(); id++)
+		if (table.oks[id] && table.metadata_image_ids[id] != 0)
+			ids[ends[table.metadata_image_ids[id]]++] = id;
+
+	std::vector<std::pair<std::uint32_t, std::uint32_t>> pairs;
+	for (std::size_t b = 1; b + 1 < bucket_begins.size(); b++)
+		for (auto i = bucket_begins[b]; i < bucket_begins[b + 1]; i++)
+			for (auto j = bucket_begins[b]; j < i; j++)
+				pairs.push_back({ids[j], ids[i]});
+	return pairs;
+}
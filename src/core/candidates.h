@@ -0,0 +1,27 @@
+#pragma once
+
+#include "image_table.h"
+#include "score.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Pairs of the ok images of table in the time category, with their time
+// distances as score() finds them, in no particular order. The images are
+// swept in order of metadata time, so only pairs of images close in time
+// are ever looked at.
+std::vector<SignaturePair> find_time_pairs(const ImageTable& table);
+
+// Pairs of the ok images of table in the location category, with their
+// distances as score() finds them, in no particular order. The directions
+// of the images are binned in a grid of cells about as wide as the
+// maximum distance, so only pairs of images in neighbouring cells are
+// ever looked at.
+std::vector<SignaturePair> find_location_pairs(const ImageTable& table);
+
+// Pairs of the ok images of table with equal metadata image ids, other
+// than empty, index_1 < index_2, in no particular order. The images are
+// bucketed by their interned ids, so finding them takes time linear in the
+// number of images and pairs, and only pairs of equal ids are looked at.
+std::vector<std::pair<std::uint32_t, std::uint32_t>> find_image_id_pairs(const ImageTable& table);
@@ -0,0 +1,110 @@
+#include "channel_sums.h"
+
+#include "../shared/assert.h"
+
+#include <algorithm>
+
+static void add_channel_sums_scalar(const std::uint8_t* const pixels, const std::size_t n_pixels, ChannelSums& sums) {
+	std::uint64_t b = 0;
+	std::uint64_t g = 0;
+	std::uint64_t r = 0;
+	std::uint64_t a = 0;
+
+	for (auto p = pixels; p != pixels + n_pixels * 4; p += 4) {
+		b += p[0];
+		g += p[1];
+		r += p[2];
+		a += p[3];
+	}
+
+	sums[0] += b;
+	sums[1] += g;
+	sums[2] += r;
+	sums[3] += a;
+}
+
+#ifdef SIMD_X86
+
+// Pixels are widened to 16 bit lanes of b, g, r, a, which each receive two
+// bytes per vector. After 128 vectors the lanes are widened to 32 bits and
+// flushed to the 64 bit sums, before the 16 bit lanes can overflow.
+const std::size_t vectors_per_flush = 128;
+
+static void add_channel_sums_sse2(const std::uint8_t* const pixels, const std::size_t n_pixels, ChannelSums& sums) {
+	const auto pixels_per_vector = 4;
+	const auto zero = _mm_setzero_si128();
+
+	std::size_t i = 0;
+	while (n_pixels - i >= pixels_per_vector) {
+		const auto n_vectors = std::min((n_pixels - i) / pixels_per_vector, vectors_per_flush);
+
+		auto sums_16 = _mm_setzero_si128();
+		for (std::size_t v = 0; v < n_vectors; v++, i += pixels_per_vector) {
+			const auto p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i * 4));
+			sums_16 = _mm_add_epi16(sums_16, _mm_unpacklo_epi8(p, zero));
+			sums_16 = _mm_add_epi16(sums_16, _mm_unpackhi_epi8(p, zero));
+		}
+
+		const auto sums_32 = _mm_add_epi32(
+			_mm_unpacklo_epi16(sums_16, zero),
+			_mm_unpackhi_epi16(sums_16, zero));
+
+		alignas(16) std::uint32_t s[4];
+		_mm_store_si128(reinterpret_cast<__m128i*>(s), sums_32);
+		for (auto c = 0; c < 4; c++)
+			sums[c] += s[c];
+	}
+
+	add_channel_sums_scalar(pixels + i * 4, n_pixels - i, sums);
+}
+
+TARGET_AVX2 static void add_channel_sums_avx2(const std::uint8_t* const pixels, const std::size_t n_pixels, ChannelSums& sums) {
+	const auto pixels_per_vector = 8;
+	const auto zero = _mm256_setzero_si256();
+
+	std::size_t i = 0;
+	while (n_pixels - i >= pixels_per_vector) {
+		const auto n_vectors = std::min((n_pixels - i) / pixels_per_vector, vectors_per_flush);
+
+		auto sums_16 = _mm256_setzero_si256();
+		for (std::size_t v = 0; v < n_vectors; v++, i += pixels_per_vector) {
+			const auto p = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pixels + i * 4));
+			sums_16 = _mm256_add_epi16(sums_16, _mm256_unpacklo_epi8(p, zero));
+			sums_16 = _mm256_add_epi16(sums_16, _mm256_unpackhi_epi8(p, zero));
+		}
+
+		const auto sums_32 = _mm256_add_epi32(
+			_mm256_unpacklo_epi16(sums_16, zero),
+			_mm256_unpackhi_epi16(sums_16, zero));
+
+		alignas(32) std::uint32_t s[8];
+		_mm256_store_si256(reinterpret_cast<__m256i*>(s), sums_32);
+		for (auto c = 0; c < 4; c++)
+			sums[c] += static_cast<std::uint64_t>(s[c]) + s[c + 4];
+	}
+
+	add_channel_sums_scalar(pixels + i * 4, n_pixels - i, sums);
+}
+
+#endif
+
+void add_channel_sums(const std::uint8_t* const pixels, const std::size_t n_pixels, ChannelSums& sums) {
+	add_channel_sums(pixels, n_pixels, sums, get_simd_level());
+}
+
+void add_channel_sums(const std::uint8_t* const pixels, const std::size_t n_pixels, ChannelSums& sums, const SimdLevel level) {
+	assert(level <= get_simd_level());
+
+	switch (level) {
+	#ifdef SIMD_X86
+	case SimdLevel::avx2:
+		add_channel_sums_avx2(pixels, n_pixels, sums);
+		break;
+	case SimdLevel::sse2:
+		add_channel_sums_sse2(pixels, n_pixels, sums);
+		break;
+	#endif
+	default:
+		add_channel_sums_scalar(pixels, n_pixels, sums);
+	}
+}
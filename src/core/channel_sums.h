@@ -0,0 +1,14 @@
+#pragma once
+
+#include "simd.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+using ChannelSums = std::array<std::uint64_t, 4>; // b, g, r, a
+
+// Adds the B, G, R and A channel sums of n_pixels 32 bpp BGRA pixels to
+// sums. All levels give identical results.
+void add_channel_sums(const std::uint8_t* const pixels, const std::size_t n_pixels, ChannelSums& sums);
+void add_channel_sums(const std::uint8_t* const pixels, const std::size_t n_pixels, ChannelSums& sums, const SimdLevel level);
@@ -0,0 +1,1046 @@
+#include "core_tests.h"
+
+#include "candidates.h"
+#include "channel_sums.h"
+#include "image_table.h"
+#include "job.h"
+#include "metadata.h"
+#include "paths.h"
+#include "scan_state.h"
+#include "score.h"
+#include "signature.h"
+#include "signature_cache.h"
+#include "summed_area_table.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+[[noreturn]] static void check_failed(const char* const condition, const char* const file, const int line) {
+	std::cerr << file << "(" << line << "): check failed: " << condition << std::endl;
+	std::abort();
+}
+
+// As assert(), but also in release builds, which the tests are run in too,
+// and reporting where.
+#define check(condition) (void)((!!(condition)) || (check_failed(#condition, __FILE__, __LINE__), 0))
+
+// 32 bpp BGRA test image with some structure that is not symmetric under
+// any rotation or flip
+static std::vector<std::uint8_t> create_test_pixels(const PixelSize& size, const bool rotate_90 = false) {
+	const auto w = rotate_90 ? size.h : size.w;
+	const auto h = rotate_90 ? size.w : size.h;
+
+	std::vector<std::uint8_t> pixels(w * h * 4);
+	for (std::uint32_t y = 0; y < h; y++) {
+		for (std::uint32_t x = 0; x < w; x++) {
+			// source coordinates
+			auto sx = rotate_90 ? y : x;
+			auto sy = rotate_90 ? size.h - 1 - x : y;
+
+			auto p = &pixels[(y*w + x) * 4];
+			p[0] = static_cast<std::uint8_t>(sx * 255 / size.w);
+			p[1] = static_cast<std::uint8_t>(sy * 255 / size.h);
+			p[2] = static_cast<std::uint8_t>(sx < size.w / 3 && sy < size.h / 4 ? 255 : 0);
+			p[3] = 255;
+		}
+	}
+	return pixels;
+}
+
+static Signature create_test_signature(const PixelSize& size, const bool rotate_90 = false) {
+	Signature signature;
+	auto pixels = create_test_pixels(size, rotate_90);
+	auto s = rotate_90 ? PixelSize{size.h, size.w} : size;
+	calculate_intensities(signature, pixels.data(), s, s.w * 4);
+	return signature;
+}
+
+static std::vector<std::uint8_t> create_random_pixels(const PixelSize& size, const unsigned seed) {
+	std::mt19937 rng{seed};
+	std::vector<std::uint8_t> pixels(size.w * size.h * 4);
+	for (auto& p : pixels)
+		p = static_cast<std::uint8_t>(rng());
+	return pixels;
+}
+
+// n signatures of random images in groups of four similar ones, with
+// random metadata that puts some pairs in each category, and every
+// seventh not ok
+static std::vector<std::shared_ptr<const Signature>> create_test_signatures(const std::size_t n, const unsigned seed) {
+	using namespace std::chrono_literals;
+	const PixelSize size{16, 12};
+	const std::wstring strings[] {L"", L"a", L"b"};
+
+	std::mt19937 rng{seed};
+	std::vector<std::shared_ptr<const Signature>> signatures;
+	std::vector<std::uint8_t> group_pixels;
+	for (std::size_t i = 0; i < n; i++) {
+		if (i % 4 == 0)
+			group_pixels = create_random_pixels(size, rng());
+		auto pixels = group_pixels;
+		for (auto& p : pixels)
+			p = static_cast<std::uint8_t>(std::clamp(p + static_cast<int>(rng() % 41) - 20, 0, 255));
+
+		Signature signature;
+		calculate_intensities(signature, pixels.data(), size, size.w * 4);
+		if (i % 7 == 3)
+			signature.status = Signature::Status::decode_failed;
+		if (rng() % 3 != 0)
+			signature.metadata_times = {std::chrono::system_clock::time_point{1000h + std::chrono::seconds{rng() % (20 * 24 * 3600)}}};
+		if (rng() % 2 != 0)
+			signature.metadata_position = {10 + (rng() % 1000) / 1000.0f, 50 + (rng() % 1000) / 1000.0f};
+		signature.metadata_make_model = strings[rng() % 3];
+		signature.metadata_camera_id = strings[rng() % 3];
+		if (rng() % 2 != 0)
+			signature.metadata_image_id = L"image " + std::to_wstring(i / 4);
+		signatures.push_back(std::make_shared<Signature>(std::move(signature)));
+	}
+	return signatures;
+}
+
+// Loader of a job that sets rows from signatures.
+static Job::Loader get_loader(const std::vector<std::shared_ptr<const Signature>>& signatures) {
+	return [&signatures](const std::uint32_t id, ImageTable& table) { table.set(id, *signatures[id]); };
+}
+
+// Pairs per category of all pairs of the ok signatures, each scored by
+// score() and then sorted, as a job should find them.
+static std::vector<std::vector<SignaturePair>> get_all_pairs(
+	const std::vector<std::shared_ptr<const Signature>>& signatures,
+	const CompareOptions& options
+) {
+	ImageTable table{signatures.size(), options};
+	for (std::uint32_t id = 0; id < signatures.size(); id++)
+		table.set(id, *signatures[id]);
+
+	std::vector<std::vector<SignaturePair>> pair_categories(n_categories);
+	for (std::uint32_t id_2 = 0; id_2 < signatures.size(); id_2++) {
+		for (std::uint32_t id_1 = 0; id_1 < id_2; id_1++) {
+			if (!table.oks[id_1] || !table.oks[id_2])
+				continue;
+			const auto s = score(table, id_1, id_2, options);
+			for (auto c = 0; c < n_categories; c++)
+				if (s.distances[c] != std::numeric_limits<float>::max())
+					pair_categories[c].push_back({id_1, id_2, s.distances[c]});
+		}
+	}
+	for (auto& pairs : pair_categories)
+		std::sort(pairs.begin(), pairs.end());
+	return pair_categories;
+}
+
+static bool is_equal(const SignaturePair& p, const SignaturePair& q) {
+	return p.index_1 == q.index_1 && p.index_2 == q.index_2 && p.distance == q.distance;
+}
+
+static bool is_equal(const std::vector<SignaturePair>& pairs_1, const std::vector<SignaturePair>& pairs_2) {
+	return std::equal(pairs_1.begin(), pairs_1.end(), pairs_2.begin(), pairs_2.end(), [](const SignaturePair& p, const SignaturePair& q) {
+		return is_equal(p, q);
+	});
+}
+
+static void test_channel_sums() {
+	// odd lengths and offsets exercise the vector remainders and unaligned
+	// loads, the long solid run the flushing of the 16 bit lanes
+	const PixelSize size{1031, 1};
+	auto pixels = create_random_pixels(size, 2);
+	std::vector<std::uint8_t> white(70001 * 4, 255);
+
+	for (auto level = SimdLevel::scalar; level <= get_simd_level(); level = static_cast<SimdLevel>(static_cast<int>(level) + 1)) {
+		for (std::size_t offset = 0; offset < 9; offset++) {
+			for (std::size_t n = 0; n + offset <= size.w; n += n < 40 ? 1 : 97) {
+				ChannelSums expected{};
+				for (auto i = offset; i < offset + n; i++)
+					for (auto c = 0; c < 4; c++)
+						expected[c] += pixels[i * 4 + c];
+
+				ChannelSums sums{1, 2, 3, 4};
+				add_channel_sums(&pixels[offset * 4], n, sums, level);
+				check(sums == (ChannelSums{expected[0] + 1, expected[1] + 2, expected[2] + 3, expected[3] + 4}));
+			}
+		}
+
+		ChannelSums sums{};
+		add_channel_sums(white.data(), 70001, sums, level);
+		check(sums == (ChannelSums{70001 * 255, 70001 * 255, 70001 * 255, 70001 * 255}));
+	}
+}
+
+static void test_summed_area_table() {
+	const PixelSize size{37, 23};
+	auto pixels = create_random_pixels(size, 1);
+
+	std::vector<std::uint32_t> columns{0, 5, 11, 11, 36, size.w};
+	std::vector<std::uint32_t> rows{size.h, 0, 1, 22, 7};
+	SummedAreaTable sat{pixels.data(), size, static_cast<int>(size.w * 4), columns, rows};
+
+	for (auto left : columns) {
+		for (auto right : columns) {
+			for (auto top : rows) {
+				for (auto bottom : rows) {
+					if (left > right || top > bottom)
+						continue;
+
+					SummedAreaTable::Sums expected{};
+					for (auto y = top; y < bottom; y++)
+						for (auto x = left; x < right; x++)
+							for (auto c = 0; c < 4; c++)
+								expected[c] += pixels[(y*size.w + x) * 4 + c];
+
+					check(sat.get_sums({left, top, right, bottom}) == expected);
+				}
+			}
+		}
+	}
+}
+
+static void test_calculate_intensities() {
+	// the blocks are summed in integers, so exactly as one block at a time
+	// and then normalized
+	const PixelSize size{101, 67};
+	auto pixels = create_random_pixels(size, 4);
+	Signature signature;
+	calculate_intensities(signature, pixels.data(), size, size.w * 4);
+
+	const PixelRect rects[] {{0, 0, 101, 67}, {0, 0, 67, 67}, {34, 0, 101, 67}};
+	const IntensityArray* arrays[] {&signature.intensities, &signature.intensities_cropped_1, &signature.intensities_cropped_2};
+	for (auto i = 0; i < 3; i++) {
+		const auto& rect = rects[i];
+		IntensityArray expected;
+		auto intensity_min = std::numeric_limits<float>::max();
+		auto intensity_max = 0.0f;
+		for (std::uint32_t by = 0; by < 8; by++) {
+			for (std::uint32_t bx = 0; bx < 8; bx++) {
+				std::uint32_t sums[3] {};
+				for (auto y = rect.top + (rect.bottom - rect.top) * by / 8; y < rect.top + (rect.bottom - rect.top) * (by + 1) / 8; y++)
+					for (auto x = rect.left + (rect.right - rect.left) * bx / 8; x < rect.left + (rect.right - rect.left) * (bx + 1) / 8; x++)
+						for (auto c = 0; c < 3; c++)
+							sums[c] += pixels[(y * size.w + x) * 4 + c];
+				expected[by][bx] = {static_cast<float>(sums[2]), static_cast<float>(sums[1]), static_cast<float>(sums[0])};
+				intensity_min = std::min({intensity_min, expected[by][bx].r, expected[by][bx].g, expected[by][bx].b});
+				intensity_max = std::max({intensity_max, expected[by][bx].r, expected[by][bx].g, expected[by][bx].b});
+			}
+		}
+		for (std::uint32_t by = 0; by < 8; by++) {
+			for (std::uint32_t bx = 0; bx < 8; bx++) {
+				auto& e = expected[by][bx];
+				const auto& a = (*arrays[i])[by][bx];
+				e = {(e.r - intensity_min) / (intensity_max - intensity_min), (e.g - intensity_min) / (intensity_max - intensity_min), (e.b - intensity_min) / (intensity_max - intensity_min)};
+				check(a.r == e.r && a.g == e.g && a.b == e.b);
+			}
+		}
+	}
+}
+
+static void test_earth_distance() {
+	float d;
+
+	d = earth_distance(Position{0, 0}, Position{0, 0});
+	check(std::abs(d - 0) < 100);
+
+	d = earth_distance(Position{0, 90}, Position{0, 0});
+	check(std::abs(d - 10*1000*1000) < 10000);
+
+	d = earth_distance(Position{0, 0}, Position{0, 90});
+	check(std::abs(d - 10*1000*1000) < 10000);
+
+	d = earth_distance(Position{0, -90}, Position{0, 90});
+	check(std::abs(d - 20*1000*1000) < 20000);
+
+	d = earth_distance(Position{0, 0}, Position{180, 0});
+	check(std::abs(d - 20*1000*1000) < 20000);
+
+	d = earth_distance(Position{0, 0}, Position{-180, 0});
+	check(std::abs(d - 20*1000*1000) < 20000);
+
+	// short distances, which are compared with the category maximum
+	d = earth_distance(Position{18.0f, 59.0f}, Position{18.0f, 59.09f});
+	check(std::abs(d - 10007.5f) < 2);
+
+	d = earth_distance(Position{18.0f, 59.0f}, Position{18.0002f, 59.0f});
+	check(std::abs(d - 11.45f) < 0.5f);
+}
+
+static void test_metadata() {
+	auto t1 = parse_metadata_time(L"2018:07:01 12:00:00");
+	auto t2 = parse_metadata_time(L"2018-07-01T13:30:00+02:00");
+	check(t1 != std::chrono::system_clock::time_point::min());
+	check(t2 - t1 == std::chrono::minutes(90));
+	check(parse_metadata_time(L"2018") == std::chrono::system_clock::time_point::min());
+
+	check(normalize_make_model(L"NIKON CORPORATION NIKON D70") == L"NIKON D70");
+	check(normalize_make_model(L" Canon  Canon EOS") == L"Canon EOS");
+}
+
+static IntensityArray create_random_intensities(std::mt19937& rng) {
+	std::uniform_real_distribution<float> dist;
+	IntensityArray intensities;
+	for (auto& row : intensities)
+		for (auto& i : row)
+			i = {dist(rng), dist(rng), dist(rng)};
+	return intensities;
+}
+
+static void test_calculate_distance() {
+	std::mt19937 rng{3};
+
+	const ImageTransform transforms[] {
+		ImageTransform::none, ImageTransform::rotate_90, ImageTransform::rotate_180, ImageTransform::rotate_270,
+		ImageTransform::flip_h, ImageTransform::flip_v, ImageTransform::flip_nw_se, ImageTransform::flip_sw_ne,
+	};
+
+	// block indices in r, to find where get_intensity() reads each block from
+	IntensityArray indices;
+	for (auto y = 0; y < 8; y++)
+		for (auto x = 0; x < 8; x++)
+			indices[y][x].r = static_cast<float>(y * 8 + x);
+
+	// an array matches exactly the transform that undoes it
+	for (auto t : transforms) {
+		const auto intensities_1 = create_random_intensities(rng);
+		IntensityArray intensities_2;
+		for (auto y = 0; y < 8; y++) {
+			for (auto x = 0; x < 8; x++) {
+				const auto i = static_cast<int>(get_intensity(indices, x, y, t).r);
+				intensities_2[i / 8][i % 8] = intensities_1[y][x];
+			}
+		}
+
+		const auto [d, arf] = calculate_distance(get_intensity_planes(intensities_1), get_intensity_planes(intensities_2), 0.6f);
+		const auto flipped = t == ImageTransform::rotate_90 || t == ImageTransform::rotate_270 || t == ImageTransform::flip_nw_se || t == ImageTransform::flip_sw_ne;
+		check(d == 0 && arf == flipped);
+	}
+
+	// vectorised and scalar evaluation agree exactly, and with the sum of
+	// one block after the other through get_intensity(), as distances were
+	// computed before, up to rounding: results are not bit-exact with those
+	for (auto i = 0; i < 100; i++) {
+		const auto intensities_1 = create_random_intensities(rng);
+		const auto intensities_2 = create_random_intensities(rng);
+		const auto planes_1 = get_intensity_planes(intensities_1);
+		const auto planes_2 = get_intensity_planes(intensities_2);
+
+		auto expected = std::numeric_limits<float>::max();
+		for (auto t : transforms) {
+			auto s = 0.0f;
+			for (auto y = 0; y < 8; y++) {
+				for (auto x = 0; x < 8; x++) {
+					auto c1 = get_intensity(intensities_1, x, y, ImageTransform::none);
+					auto c2 = get_intensity(intensities_2, x, y, t);
+					s += std::abs(c2.r - c1.r) + std::abs(c2.g - c1.g) + std::abs(c2.b - c1.b);
+				}
+			}
+			expected = std::min(expected, s / 64);
+		}
+
+		for (auto maximum_distance : {0.5f, 1.0f, 3.0f}) {
+			const auto d = calculate_distance(planes_1, planes_2, maximum_distance, SimdLevel::scalar);
+			check(calculate_distance(planes_1, planes_2, maximum_distance) == d);
+			if (expected < maximum_distance * 0.999f)
+				check(std::abs(d.first - expected) < 1e-5f);
+			else if (expected > maximum_distance * 1.001f)
+				check(d.first == maximum_distance);
+		}
+	}
+}
+
+static void test_coarse_planes() {
+	std::mt19937 rng{7};
+	std::uniform_real_distribution<float> noise{-1, 1};
+
+	// the coarser levels are block averages
+	const auto planes = get_intensity_planes(create_random_intensities(rng));
+	auto average = [](const IntensityPlanes::Plane& plane, const int x0, const int y0, const int size) {
+		auto sum = 0.0f;
+		for (auto y = y0; y < y0 + size; y++)
+			for (auto x = x0; x < x0 + size; x++)
+				sum += plane[y][x];
+		return sum / (size * size);
+	};
+	for (auto c = 0; c < 3; c++) {
+		check(std::abs(planes.means[c] - average(planes.rows[c], 0, 0, 8)) < 1e-6f);
+		check(std::abs(planes.planes_2.rows[c][1][0] - average(planes.rows[c], 0, 4, 4)) < 1e-6f);
+		check(std::abs(planes.planes_4.columns[c][3][1] - average(planes.rows[c], 6, 2, 2)) < 1e-6f);
+	}
+
+	// rejecting transforms by the coarser levels changes no distance: with
+	// equal coarser levels nothing is rejected
+	for (auto i = 0; i < 200; i++) {
+		const auto intensities_1 = create_random_intensities(rng);
+		auto intensities_2 = intensities_1;
+		const auto amount = i / 200.0f;
+		for (auto& row : intensities_2)
+			for (auto& b : row)
+				b = {b.r + amount * noise(rng), b.g + amount * noise(rng), b.b + amount * noise(rng)};
+		const auto planes_1 = get_intensity_planes(intensities_1);
+		const auto planes_2 = get_intensity_planes(intensities_2);
+		auto planes_2_unrejected = planes_2;
+		planes_2_unrejected.planes_4 = planes_1.planes_4;
+		planes_2_unrejected.planes_2 = planes_1.planes_2;
+		planes_2_unrejected.means = planes_1.means;
+
+		for (auto maximum_distance : {0.05f, 0.1f, 0.2f, 0.37f, 0.6f})
+			for (auto level : {SimdLevel::scalar, get_simd_level()})
+				check(calculate_distance(planes_1, planes_2, maximum_distance, level) ==
+					calculate_distance(planes_1, planes_2_unrejected, maximum_distance, level));
+	}
+}
+
+static void test_canonical_orientation() {
+	std::mt19937 rng{4};
+	std::uniform_real_distribution<float> dist{0, 0.2f};
+
+	const ImageTransform transforms[] {
+		ImageTransform::none, ImageTransform::rotate_90, ImageTransform::rotate_180, ImageTransform::rotate_270,
+		ImageTransform::flip_h, ImageTransform::flip_v, ImageTransform::flip_nw_se, ImageTransform::flip_sw_ne,
+	};
+
+	// quadrants different enough to have a canonical orientation
+	const float quadrants[2][2] {{0.1f, 0.7f}, {0.4f, 0.0f}};
+	IntensityArray intensities_1;
+	for (auto y = 0; y < 8; y++)
+		for (auto x = 0; x < 8; x++)
+			intensities_1[y][x] = {quadrants[y / 4][x / 4] + dist(rng), quadrants[y / 4][x / 4] + dist(rng), dist(rng)};
+
+	Signature s1;
+	s1.intensities = s1.intensities_cropped_1 = s1.intensities_cropped_2 = intensities_1;
+	check(get_intensity_planes(intensities_1).canonical_transform);
+
+	for (auto t : transforms) {
+		IntensityArray intensities_2;
+		for (auto y = 0; y < 8; y++)
+			for (auto x = 0; x < 8; x++)
+				intensities_2[y][x] = get_intensity(intensities_1, x, y, t);
+
+		Signature s2;
+		s2.intensities = s2.intensities_cropped_1 = s2.intensities_cropped_2 = intensities_2;
+		check(get_intensity_planes(intensities_2).canonical_transform);
+
+		const auto flipped = t == ImageTransform::rotate_90 || t == ImageTransform::rotate_270 || t == ImageTransform::flip_nw_se || t == ImageTransform::flip_sw_ne;
+		auto [d, arf, c] = distance(s1, s2, 0.6f, {true});
+		check(d == 0 && arf == flipped && !c);
+		check(distance(s1, s2, 0.6f) == distance(s1, s2, 0.6f, {true}));
+	}
+
+	// no canonical orientation without a clearly brightest quadrant
+	IntensityArray flat{};
+	check(!get_intensity_planes(flat).canonical_transform);
+}
+
+static void test_quantized_distance() {
+	std::mt19937 rng{5};
+
+	for (auto i = 0; i < 100; i++) {
+		const auto planes_1 = get_intensity_planes(create_random_intensities(rng));
+		auto intensities_2 = create_random_intensities(rng);
+		// some near matches too
+		if (i % 2)
+			for (auto& row : intensities_2)
+				for (auto& c : row)
+					c.r = c.g = c.b = 0.5f;
+		const auto planes_2 = get_intensity_planes(intensities_2);
+
+		const auto quantized_1 = quantize(planes_1);
+		const auto quantized_2 = quantize(planes_2);
+
+		for (auto maximum_distance : {0.37f, 0.6f, 3.0f}) {
+			const auto d = calculate_distance(planes_1, planes_2, maximum_distance);
+			const auto q = calculate_distance(quantized_1, quantized_2, maximum_distance, SimdLevel::scalar);
+			check(calculate_distance(quantized_1, quantized_2, maximum_distance) == q);
+			check(std::abs(q.first - d.first) <= 3 / 255.0f + 1e-6f);
+		}
+	}
+
+	// an array matches exactly the transform that undoes it
+	const auto intensities = create_random_intensities(rng);
+	const auto quantized = quantize(get_intensity_planes(intensities));
+	for (auto t = 0; t < 8; t++) {
+		IntensityArray transformed;
+		for (auto y = 0; y < 8; y++)
+			for (auto x = 0; x < 8; x++)
+				transformed[y][x] = get_intensity(intensities, x, y, static_cast<ImageTransform>(t));
+		check(calculate_distance(quantize(get_intensity_planes(transformed)), quantized, 0.6f).first == 0);
+	}
+}
+
+static void test_distance() {
+	auto s1 = create_test_signature({64, 48});
+	auto s2 = create_test_signature({64, 48}, true);
+	auto s3 = create_test_signature({32, 24});
+
+	auto [d11, arf11, c11] = distance(s1, s1, 0.6f);
+	check(d11 == 0 && !arf11 && !c11);
+
+	auto [d12, arf12, c12] = distance(s1, s2, 0.6f);
+	check(d12 < 0.001f && arf12);
+
+	auto [d13, arf13, c13] = distance(s1, s3, 0.6f);
+	check(d13 < 0.05f && !arf13);
+
+	for (const auto& intensities : {s1.intensities, s1.intensities_cropped_1, s1.intensities_cropped_2}) {
+		for (const auto& row : intensities) {
+			for (const auto& i : row) {
+				check(i.r >= 0 && i.r <= 1);
+				check(i.g >= 0 && i.g <= 1);
+				check(i.b >= 0 && i.b <= 1);
+			}
+		}
+	}
+}
+
+static void test_image_table() {
+	using namespace std::chrono_literals;
+	const std::chrono::system_clock::time_point t{1000h};
+
+	Signature s1;
+	s1.metadata_make_model = L"Camera";
+	s1.metadata_times = {t};
+
+	Signature s2;
+	s2.status = Signature::Status::decode_failed;
+	s2.metadata_make_model = L"Camera";
+	s2.metadata_camera_id = L"1234";
+	s2.metadata_times = {t, t + 1h};
+
+	ImageTable table{3, {}};
+	table.set(0, s1);
+	table.set(1, s2);
+	table.set(2, Signature{});
+
+	check(table.size() == 3 && table.planes.size() == 3 && table.quantized_planes.empty());
+	check(table.oks[0] && !table.oks[1] && table.oks[2]);
+
+	check(table.metadata_make_model_ids[0] != 0 && table.metadata_make_model_ids[0] == table.metadata_make_model_ids[1]);
+	check(table.metadata_camera_ids[0] == 0 && table.metadata_camera_ids[1] != 0);
+	check(table.metadata_camera_ids[1] != table.metadata_make_model_ids[0]);
+
+	auto times = table.get_metadata_times(0);
+	check(times.second - times.first == 1 && *times.first == t);
+	times = table.get_metadata_times(1);
+	check(times.second - times.first == 2 && times.first[1] == t + 1h);
+	times = table.get_metadata_times(2);
+	check(times.first == times.second);
+
+	// only the planes of the options are computed, from the intensities
+	const auto s3 = create_test_signature({64, 48});
+	ImageTable quantized_table{1, {false, true}};
+	quantized_table.set(0, s3);
+	check(quantized_table.planes.empty());
+	check(quantized_table.quantized_planes[0][2].rows == quantize(get_intensity_planes(s3.intensities_cropped_2)).rows);
+}
+
+static void test_find_time_pairs() {
+	using namespace std::chrono_literals;
+
+	// random times, up to three per image, about 12 hours apart, and some
+	// images without any or not ok
+	std::mt19937 rng;
+	const std::uint32_t n_images = 50;
+	ImageTable table{n_images, {}};
+	for (std::uint32_t id = 0; id < n_images; id++) {
+		auto signature = create_test_signature({32, 24});
+		if (id % 7 == 0)
+			signature.status = Signature::Status::decode_failed;
+		for (auto i = rng() % 4; i > 0; i--)
+			signature.metadata_times.push_back(std::chrono::system_clock::time_point{1000h + std::chrono::seconds{rng() % (30 * 24 * 3600)}});
+		normalize_metadata_times(signature.metadata_times);
+		table.set(id, signature);
+	}
+
+	std::vector<SignaturePair> expected;
+	for (std::uint32_t id_2 = 0; id_2 < n_images; id_2++) {
+		for (std::uint32_t id_1 = 0; id_1 < id_2; id_1++) {
+			if (!table.oks[id_1] || !table.oks[id_2])
+				continue;
+			auto distance = score(table, id_1, id_2, {}).distances[static_cast<int>(Category::time)];
+			if (distance != std::numeric_limits<float>::max())
+				expected.push_back({id_1, id_2, distance});
+		}
+	}
+	check(!expected.empty());
+
+	auto pairs = find_time_pairs(table);
+	std::sort(expected.begin(), expected.end());
+	std::sort(pairs.begin(), pairs.end());
+	check(pairs.size() == expected.size());
+	for (std::size_t i = 0; i < pairs.size(); i++) {
+		check(pairs[i].index_1 == expected[i].index_1);
+		check(pairs[i].index_2 == expected[i].index_2);
+		check(pairs[i].distance == expected[i].distance);
+	}
+}
+
+static void test_find_location_pairs() {
+	// random positions in an area of about 50 by 50 km, and some images
+	// without any or not ok
+	std::mt19937 rng;
+	std::uniform_real_distribution<float> offset{0, 0.5f};
+	const std::uint32_t n_images = 100;
+	ImageTable table{n_images, {}};
+	for (std::uint32_t id = 0; id < n_images; id++) {
+		auto signature = create_test_signature({32, 24});
+		if (id % 7 == 0)
+			signature.status = Signature::Status::decode_failed;
+		if (id % 5 != 0)
+			signature.metadata_position = {179.75f + offset(rng), 45 + offset(rng)};
+		if (signature.metadata_position.x > 180)
+			signature.metadata_position.x -= 360;
+		table.set(id, signature);
+	}
+
+	std::vector<SignaturePair> expected;
+	for (std::uint32_t id_2 = 0; id_2 < n_images; id_2++) {
+		for (std::uint32_t id_1 = 0; id_1 < id_2; id_1++) {
+			if (!table.oks[id_1] || !table.oks[id_2])
+				continue;
+			auto distance = score(table, id_1, id_2, {}).distances[static_cast<int>(Category::location)];
+			if (distance != std::numeric_limits<float>::max())
+				expected.push_back({id_1, id_2, distance});
+		}
+	}
+	check(!expected.empty());
+
+	auto pairs = find_location_pairs(table);
+	std::sort(expected.begin(), expected.end());
+	std::sort(pairs.begin(), pairs.end());
+	check(pairs.size() == expected.size());
+	for (std::size_t i = 0; i < pairs.size(); i++) {
+		check(pairs[i].index_1 == expected[i].index_1);
+		check(pairs[i].index_2 == expected[i].index_2);
+		check(pairs[i].distance == expected[i].distance);
+	}
+}
+
+static void test_find_image_id_pairs() {
+	// image ids shared by a few images each, and some images without any
+	// or not ok
+	const std::uint32_t n_images = 100;
+	ImageTable table{n_images, {}};
+	for (std::uint32_t id = 0; id < n_images; id++) {
+		auto signature = create_test_signature({32, 24});
+		if (id % 7 == 0)
+			signature.status = Signature::Status::decode_failed;
+		if (id % 5 != 0)
+			signature.metadata_image_id = L"image " + std::to_wstring(id * 13 % 17);
+		table.set(id, signature);
+	}
+
+	std::vector<std::pair<std::uint32_t, std::uint32_t>> expected;
+	for (std::uint32_t id_2 = 0; id_2 < n_images; id_2++)
+		for (std::uint32_t id_1 = 0; id_1 < id_2; id_1++)
+			if (table.oks[id_1] && table.oks[id_2] && table.metadata_image_ids[id_1] != 0 && table.metadata_image_ids[id_1] == table.metadata_image_ids[id_2])
+				expected.push_back({id_1, id_2});
+	check(!expected.empty());
+
+	auto pairs = find_image_id_pairs(table);
+	std::sort(expected.begin(), expected.end());
+	std::sort(pairs.begin(), pairs.end());
+	check(pairs == expected);
+}
+
+static void test_signature_pair_order() {
+	check((SignaturePair{5, 6, 0.25f} < SignaturePair{0, 1, 0.5f}));
+	check((SignaturePair{0, 2, 0.5f} < SignaturePair{1, 2, 0.5f}));
+	check((SignaturePair{0, 1, 0.5f} < SignaturePair{0, 2, 0.5f}));
+	check(!(SignaturePair{0, 1, 0.5f} < SignaturePair{0, 1, 0.5f}));
+	check((SignaturePair{0, 1, 0.0f} < SignaturePair{0, 1, 1e-30f}));
+	check((SignaturePair{0, 1, -1.0f} < SignaturePair{0, 1, 0.0f}));
+	check((SignaturePair{0, 1, 2.0f} < SignaturePair{0, 1, std::numeric_limits<float>::max()}));
+}
+
+static void test_job() {
+	auto failed = std::make_shared<Signature>();
+	failed->status = Signature::Status::decode_failed;
+
+	std::vector<std::shared_ptr<const Signature>> signatures{
+		std::make_shared<Signature>(create_test_signature({64, 48})),
+		std::make_shared<Signature>(create_test_signature({64, 48}, true)),
+		std::make_shared<Signature>(create_test_signature({32, 24})),
+		failed,
+	};
+
+	const auto load = get_loader(signatures);
+	auto run = [](Job& job) {
+		std::thread decoder{[&job] { job.decode(); }};
+		std::thread comparer{[&job] { job.work(); }};
+		job.work();
+		comparer.join();
+		decoder.join();
+		check(job.is_completed());
+		check(job.get_progress() == 1);
+	};
+
+	Job job{signatures.size(), load};
+	run(job);
+
+	const auto& visual = job.get_pair_categories()[static_cast<int>(Category::visual)];
+	check(visual.size() == 3);
+	check(std::is_sorted(visual.begin(), visual.end()));
+	for (const auto& p : visual) {
+		check(p.index_1 < p.index_2);
+		check(p.index_2 < 3);
+		check(p.distance < 0.37f);
+	}
+	check(job.get_pair_categories()[static_cast<int>(Category::time)].empty());
+	check(job.get_pair_categories()[static_cast<int>(Category::location)].empty());
+
+	// pairs of images compared before are taken as they are, the others are
+	// compared
+	ComparedPairs compared;
+	compared.images = {true, true, false, false};
+	compared.pair_categories[static_cast<int>(Category::visual)] = {{0, 1, 0.125f}};
+	compared.pair_categories[static_cast<int>(Category::time)] = {{0, 1, 0.0f}};
+	Job rescan_job{signatures.size(), load, {}, compared};
+	run(rescan_job);
+	const auto& rescan_visual = rescan_job.get_pair_categories()[static_cast<int>(Category::visual)];
+	check(rescan_visual.size() == 3);
+	check(std::is_sorted(rescan_visual.begin(), rescan_visual.end()));
+	for (const auto& p : visual) {
+		const SignaturePair expected = p.index_2 == 2 ? p : SignaturePair{0, 1, 0.125f};
+		check(std::any_of(rescan_visual.begin(), rescan_visual.end(), [&](const SignaturePair& r) { return is_equal(r, expected); }));
+	}
+	check(rescan_job.get_pair_categories()[static_cast<int>(Category::time)].empty());
+
+	// with all images compared before, nothing is
+	compared.images = {true, true, true, true};
+	Job unchanged_job{signatures.size(), load, {}, compared};
+	run(unchanged_job);
+	check(unchanged_job.get_pair_categories()[static_cast<int>(Category::visual)].size() == 1);
+
+	// but all images are still loaded, also with no tile left (a multiple of
+	// the tile size), for the time pairs
+	using namespace std::chrono_literals;
+	auto timed = std::make_shared<Signature>(create_test_signature({32, 24}));
+	timed->metadata_times = {std::chrono::system_clock::time_point{1000h}};
+	const auto n_timed = 2 * Job::get_tile_size({});
+	std::vector<std::shared_ptr<const Signature>> timed_signatures(n_timed, timed);
+	ComparedPairs all_compared;
+	all_compared.images.assign(n_timed, true);
+	Job timed_job{n_timed, get_loader(timed_signatures), {}, all_compared};
+	run(timed_job);
+	check(timed_job.get_pair_categories()[static_cast<int>(Category::visual)].empty());
+	check(timed_job.get_pair_categories()[static_cast<int>(Category::time)].size() == n_timed * (n_timed - 1) / 2);
+
+	// tiled, over several rows of tiles and with the runs of two comparing
+	// threads merged, the pairs are those of all pairs scored one by one,
+	// in the same order
+	for (const auto quantized : {false, true}) {
+		const CompareOptions options{false, quantized};
+		const auto n_many = 2 * Job::get_tile_size(options) + 13;
+		const auto many = create_test_signatures(n_many, 1);
+		const auto expected = get_all_pairs(many, options);
+		Job many_job{n_many, get_loader(many), options};
+		run(many_job);
+		for (auto c = 0; c < n_categories; c++) {
+			check(!expected[c].empty());
+			check(is_equal(many_job.get_pair_categories()[c], expected[c]));
+		}
+	}
+
+	// and so do those of a rescan, of a third of the images changed, so
+	// that the images compared before, not a multiple of the tile size,
+	// span several blocks and share tiles with the changed ones
+	const auto n_rescan = 3 * Job::get_tile_size({}) + 20;
+	const auto rescan_signatures = create_test_signatures(n_rescan, 2);
+	const auto expected = get_all_pairs(rescan_signatures, {});
+	ComparedPairs rescan_compared;
+	for (std::size_t i = 0; i < n_rescan; i++)
+		rescan_compared.images.push_back(i % 3 != 1);
+	const auto n_compared = static_cast<std::size_t>(std::count(rescan_compared.images.begin(), rescan_compared.images.end(), true));
+	check(n_compared % Job::get_tile_size({}) != 0 && n_compared > 2 * Job::get_tile_size({}));
+	for (auto c = 0; c < n_categories; c++)
+		for (const auto& p : expected[c])
+			if (rescan_compared.images[p.index_1] && rescan_compared.images[p.index_2])
+				rescan_compared.pair_categories[c].push_back(p);
+	Job changed_job{n_rescan, get_loader(rescan_signatures), {}, rescan_compared};
+	run(changed_job);
+	for (auto c = 0; c < n_categories; c++)
+		check(is_equal(changed_job.get_pair_categories()[c], expected[c]));
+}
+
+static void test_signature_cache() {
+	using namespace std::chrono_literals;
+
+	auto signature = create_test_signature({64, 48});
+	const auto pixels = create_test_pixels({64, 48});
+	signature.file_hash = Hash(pixels.data(), 100);
+	signature.pixel_hash = Hash(pixels.data(), pixels.size());
+	signature.metadata_times = {std::chrono::system_clock::time_point{1000h}, std::chrono::system_clock::time_point{1001h}};
+	signature.metadata_make_model = L"Camera \u00e9";
+	signature.metadata_image_id = L"1234";
+	signature.metadata_position = {12.5f, -45.25f};
+
+	auto failed = Signature{};
+	failed.status = Signature::Status::decode_failed;
+	failed.image_size = {0, 0};
+
+	auto is_equal = [&](const Signature& s) {
+		return
+			s.status == signature.status &&
+			s.image_size.w == signature.image_size.w && s.image_size.h == signature.image_size.h &&
+			std::memcmp(&s.intensities, &signature.intensities, sizeof(IntensityArray)) == 0 &&
+			std::memcmp(&s.intensities_cropped_1, &signature.intensities_cropped_1, sizeof(IntensityArray)) == 0 &&
+			std::memcmp(&s.intensities_cropped_2, &signature.intensities_cropped_2, sizeof(IntensityArray)) == 0 &&
+			s.metadata_times == signature.metadata_times &&
+			s.metadata_make_model == signature.metadata_make_model &&
+			s.metadata_camera_id.empty() &&
+			s.metadata_image_id == signature.metadata_image_id &&
+			s.metadata_position.x == signature.metadata_position.x &&
+			s.metadata_position.y == signature.metadata_position.y &&
+			s.file_hash == signature.file_hash &&
+			s.pixel_hash == signature.pixel_hash;
+	};
+
+	// entries are found by path and stamp
+	const FileStamp stamp{1234, 5678};
+	SignatureCache cache;
+	cache.insert(L"a/b.jpg", stamp, signature);
+	cache.insert(L"a/c.jpg", stamp, failed);
+	auto open_failed = Signature{};
+	open_failed.status = Signature::Status::open_failed;
+	cache.insert(L"a/d.jpg", stamp, open_failed);
+	check(cache.size() == 2);
+	check(is_equal(*cache.find(L"a/b.jpg", stamp)));
+	check(cache.find(L"a/c.jpg", stamp)->status == Signature::Status::decode_failed);
+	check(!cache.find(L"a/b.jpg", {1234, 5679}));
+	check(!cache.find(L"a/b.jpg", {1235, 5678}));
+	check(!cache.find(L"a/d.jpg", stamp));
+
+	// saved and loaded
+	const auto path = std::filesystem::temp_directory_path() / "pixiple_core_tests" / "signatures.cache";
+	check(cache.save(path));
+	check(!std::filesystem::exists(path.string() + ".tmp"));
+	check(cache.size() == 2 && is_equal(*cache.find(L"a/b.jpg", stamp)));
+	SignatureCache loaded;
+	loaded.load(path);
+	check(loaded.size() == 2);
+	check(is_equal(*loaded.find(L"a/b.jpg", stamp)));
+
+	// inserted entries are merged into the file, replacing those of their paths
+	const FileStamp other_stamp{1234, 5679};
+	loaded.insert(L"a/a.jpg", stamp, signature);
+	loaded.insert(L"a/c.jpg", other_stamp, signature);
+	check(loaded.size() == 3);
+	check(is_equal(*loaded.find(L"a/c.jpg", other_stamp)));
+	check(loaded.save(path));
+	SignatureCache merged;
+	merged.load(path);
+	check(merged.size() == 3);
+	check(is_equal(*merged.find(L"a/a.jpg", stamp)));
+	check(is_equal(*merged.find(L"a/b.jpg", stamp)));
+	check(is_equal(*merged.find(L"a/c.jpg", other_stamp)));
+	check(!merged.find(L"a/c.jpg", stamp));
+
+	std::vector<char> data(static_cast<std::size_t>(std::filesystem::file_size(path)));
+	std::ifstream{path, std::ios::binary}.read(data.data(), data.size());
+	auto load_changed = [&](const std::vector<char>& changed) {
+		std::ofstream{path, std::ios::binary | std::ios::trunc}.write(changed.data(), changed.size());
+		SignatureCache changed_cache;
+		changed_cache.load(path);
+		return changed_cache.size();
+	};
+
+	// a damaged record is not found, the records around it are (the records
+	// are in path order, so the first with these intensities is of a/a.jpg)
+	auto damaged = data;
+	const auto intensities = reinterpret_cast<const char*>(&signature.intensities);
+	const auto i = std::search(damaged.begin(), damaged.end(), intensities, intensities + sizeof(IntensityArray));
+	check(i != damaged.end());
+	i[5] ^= 1;
+	std::ofstream{path, std::ios::binary | std::ios::trunc}.write(damaged.data(), damaged.size());
+	SignatureCache damaged_cache;
+	damaged_cache.load(path);
+	check(!damaged_cache.find(L"a/a.jpg", stamp));
+	check(is_equal(*damaged_cache.find(L"a/b.jpg", stamp)));
+
+	// a row set in place, from the file or an entry inserted since, is the
+	// row set from the signature
+	ImageTable table{4, {}};
+	table.set(0, signature);
+	check(damaged_cache.find(L"a/b.jpg", stamp, table, 1));
+	damaged_cache.insert(L"a/e.jpg", stamp, signature);
+	check(damaged_cache.find(L"a/e.jpg", stamp, table, 2));
+	check(!damaged_cache.find(L"a/a.jpg", stamp, table, 3));
+	check(!damaged_cache.find(L"a/b.jpg", other_stamp, table, 3));
+	check(!table.oks[3]);
+	for (const std::uint32_t i : {1, 2}) {
+		for (auto j = 0; j < 3; ++j) {
+			check(std::memcmp(&table.planes[i][j].rows, &table.planes[0][j].rows, sizeof table.planes[0][j].rows) == 0);
+			check(std::memcmp(&table.planes[i][j].columns, &table.planes[0][j].columns, sizeof table.planes[0][j].columns) == 0);
+		}
+		check(table.oks[i] == table.oks[0]);
+		check(table.image_sizes[i].w == table.image_sizes[0].w && table.image_sizes[i].h == table.image_sizes[0].h);
+		check(std::memcmp(&table.metadata_directions[i], &table.metadata_directions[0], sizeof(Direction)) == 0);
+		check(table.metadata_times[i].time == table.metadata_times[0].time && table.metadata_times[i].n == table.metadata_times[0].n);
+		check(table.all_metadata_times[i] == table.all_metadata_times[0]);
+		check(table.metadata_make_model_ids[i] == table.metadata_make_model_ids[0] && table.metadata_make_model_ids[0] != 0);
+		check(table.metadata_camera_ids[i] == 0);
+		check(table.metadata_image_ids[i] == table.metadata_image_ids[0]);
+	}
+
+	// a truncated cache or a cache of another version is ignored
+	check(load_changed({data.begin(), data.end() - 1}) == 0);
+	auto other_version = data;
+	other_version[8] ^= 1;
+	check(load_changed(other_version) == 0);
+	check(load_changed(data) == 3);
+
+	// entries neither found nor inserted for max_unused_days are dropped
+	auto get_size_saved_after = [&](const int days, const bool is_a_found) {
+		SignatureCache aged;
+		aged.load(path);
+		if (is_a_found)
+			check(aged.find(L"a/a.jpg", stamp) != nullptr);
+		check(aged.save(path, std::chrono::system_clock::now() + std::chrono::hours{24 * days}));
+		SignatureCache saved;
+		saved.load(path);
+		return saved.size();
+	};
+	const int max_days = SignatureCache::max_unused_days;
+	check(get_size_saved_after(max_days, false) == 3);
+	check(get_size_saved_after(max_days + 2, true) == 1);
+	check(get_size_saved_after(2 * max_days + 2, false) == 1);
+	check(get_size_saved_after(2 * max_days + 4, false) == 0);
+
+	// moved or copied files are found by content, once confirmed by the hash
+	// of the whole file
+	std::vector<char> content(100 * 1000);
+	for (std::size_t j = 0; j < content.size(); j++)
+		content[j] = static_cast<char>(j * 7);
+	auto write_file = [&](const std::filesystem::path& p, const std::vector<char>& c) {
+		std::ofstream{p, std::ios::binary | std::ios::trunc}.write(c.data(), c.size());
+		return *get_file_stamp(p);
+	};
+	auto content_signature = signature;
+	content_signature.file_hash = Hash(reinterpret_cast<const std::uint8_t*>(content.data()), content.size());
+	auto same_start = content;
+	same_start.back()++;
+	const auto folder = path.parent_path();
+	SignatureCache content_cache;
+	content_cache.insert(folder / "a.jpg", write_file(folder / "a.jpg", content), content_signature);
+	const auto moved_stamp = write_file(folder / "b.jpg", content);
+	const auto changed_stamp = write_file(folder / "c.jpg", same_start);
+	check(!content_cache.find(folder / "b.jpg", moved_stamp));
+	check(content_cache.find_by_content(folder / "b.jpg", moved_stamp)->file_hash == content_signature.file_hash);
+	check(!content_cache.find_by_content(folder / "c.jpg", changed_stamp));
+	check(content_cache.save(path));
+	SignatureCache loaded_content_cache;
+	loaded_content_cache.load(path);
+	check(loaded_content_cache.find_by_content(folder / "b.jpg", moved_stamp)->file_hash == content_signature.file_hash);
+	check(!loaded_content_cache.find_by_content(folder / "c.jpg", changed_stamp));
+
+	// a missing cache is ignored
+	std::filesystem::remove_all(path.parent_path());
+	SignatureCache missing;
+	missing.load(path);
+	check(missing.size() == 0);
+}
+
+static void test_scan_state() {
+	ScanState state;
+	state.options.quantized = true;
+	state.paths = {L"a/b.jpg", L"a/c.jpg", L"a/d.jpg", L"a/e.jpg"};
+	state.stamps = {FileStamp{1, 2}, FileStamp{3, 4}, FileStamp{5, 6}, std::nullopt};
+	state.pair_categories[static_cast<int>(Category::visual)] = {{0, 2, 0.25f}, {1, 2, 0.25f}, {0, 3, 0.5f}};
+	state.pair_categories[static_cast<int>(Category::combined)] = {{0, 2, 0.75f}};
+
+	// saved and loaded
+	const auto path = std::filesystem::temp_directory_path() / "pixiple_core_tests" / "scan.state";
+	check(state.save(path));
+	check(!std::filesystem::exists(path.string() + ".tmp"));
+	ScanState loaded;
+	check(loaded.load(path));
+	check(loaded.options.quantized && !loaded.options.canonical_orientation);
+	check(loaded.paths == state.paths);
+	check(loaded.stamps == state.stamps);
+	for (auto c = 0; c < n_categories; c++)
+		check(is_equal(loaded.pair_categories[c], state.pair_categories[c]));
+
+	// pairs of images removed (a/c.jpg), changed (a/d.jpg) or without stamps
+	// (a/e.jpg) are dropped, and the others reindexed
+	const std::vector<std::filesystem::path> paths{L"a/a.jpg", L"a/b.jpg", L"a/d.jpg", L"a/e.jpg", L"b/a.jpg"};
+	const std::vector<std::optional<FileStamp>> stamps{FileStamp{1, 2}, FileStamp{1, 2}, FileStamp{5, 7}, FileStamp{7, 8}, FileStamp{5, 6}};
+	state.pair_categories[static_cast<int>(Category::visual)].push_back({0, 1, 0.75f});
+	auto compared = get_compared_pairs(state, paths, stamps, state.options);
+	check((compared.images == std::vector<std::uint8_t>{false, true, false, false, false}));
+	check(std::all_of(compared.pair_categories.begin(), compared.pair_categories.end(), [](const auto& p) { return p.empty(); }));
+	state.stamps[2] = stamps[2];
+	compared = get_compared_pairs(state, paths, stamps, state.options);
+	check((compared.images == std::vector<std::uint8_t>{false, true, true, false, false}));
+	check(is_equal(compared.pair_categories[static_cast<int>(Category::visual)], {{1, 2, 0.25f}}));
+	check(is_equal(compared.pair_categories[static_cast<int>(Category::combined)], {{1, 2, 0.75f}}));
+
+	// nothing is taken from a scan with other options
+	compared = get_compared_pairs(state, paths, stamps, {});
+	check(compared.images.empty());
+
+	// a truncated or damaged file, or one of another version, is ignored
+	std::vector<char> data(static_cast<std::size_t>(std::filesystem::file_size(path)));
+	std::ifstream{path, std::ios::binary}.read(data.data(), data.size());
+	auto load_changed = [&](const std::vector<char>& changed) {
+		std::ofstream{path, std::ios::binary | std::ios::trunc}.write(changed.data(), changed.size());
+		ScanState changed_state;
+		return changed_state.load(path);
+	};
+	check(load_changed(data));
+	check(!load_changed({data.begin(), data.end() - 1}));
+	auto damaged = data;
+	damaged[8] ^= 1;
+	check(!load_changed(damaged));
+	damaged = data;
+	damaged[data.size() - 8] ^= 0x10; // index_2 of the last pair
+	check(!load_changed(damaged));
+	damaged = data;
+	damaged[data.size() - 1] ^= 0x01; // distance of the last pair, still valid
+	check(!load_changed(damaged));
+	damaged = data;
+	damaged[data.size() - 12 * 4 - 1] ^= 0x20; // last character of the paths
+	check(!load_changed(damaged));
+
+	// a missing file is ignored, and the state is kept
+	std::filesystem::remove_all(path.parent_path());
+	check(!loaded.load(path));
+	check(loaded.paths.size() == 4);
+}
+
+static void test_paths() {
+	check(is_image(L"a/b.JPG"));
+	check(is_image(L"a.bmp"));
+	check(is_image(L"a.tif"));
+	check(!is_image(L"a.txt"));
+	check(!is_image(L"jpg"));
+}
+
+void core_tests() {
+	test_channel_sums();
+	test_summed_area_table();
+	test_calculate_intensities();
+	test_earth_distance();
+	test_metadata();
+	test_calculate_distance();
+	test_coarse_planes();
+	test_quantized_distance();
+	test_distance();
+	test_canonical_orientation();
+	test_image_table();
+	test_find_time_pairs();
+	test_find_location_pairs();
+	test_find_image_id_pairs();
+	test_signature_pair_order();
+	test_job();
+	test_signature_cache();
+	test_scan_state();
+	test_paths();
+}
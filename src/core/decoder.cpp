@@ -0,0 +1,135 @@
+#include "decoder.h"
+
+#include "metadata.h"
+
+#include "../shared/assert.h"
+
+#include <algorithm>
+#include <csetjmp>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+#include <jpeglib.h>
+#include <png.h>
+
+struct DecodedImage {
+	PixelSize size{0, 0};
+	std::vector<std::uint8_t> pixels; // 32 bpp BGRA, premultiplied
+};
+
+struct JpegErrorManager {
+	jpeg_error_mgr manager;
+	std::jmp_buf jump_buffer;
+};
+
+static void jpeg_error_exit(j_common_ptr cinfo) {
+	auto error_manager = reinterpret_cast<JpegErrorManager*>(cinfo->err);
+	std::longjmp(error_manager->jump_buffer, 1);
+}
+
+static void jpeg_output_message(j_common_ptr) {
+}
+
+static bool decode_jpeg(const std::vector<std::uint8_t>& data, DecodedImage& image) {
+	jpeg_decompress_struct cinfo;
+	JpegErrorManager error_manager;
+	cinfo.err = jpeg_std_error(&error_manager.manager);
+	error_manager.manager.error_exit = jpeg_error_exit;
+	error_manager.manager.output_message = jpeg_output_message;
+
+	// no objects with destructors may be created between setjmp and longjmp
+	auto& pixels = image.pixels;
+	if (setjmp(error_manager.jump_buffer)) {
+		jpeg_destroy_decompress(&cinfo);
+		return false;
+	}
+
+	jpeg_create_decompress(&cinfo);
+	jpeg_mem_src(&cinfo, data.data(), static_cast<unsigned long>(data.size()));
+	jpeg_read_header(&cinfo, TRUE);
+	cinfo.out_color_space = JCS_EXT_BGRA;
+	jpeg_start_decompress(&cinfo);
+
+	image.size = {cinfo.output_width, cinfo.output_height};
+	const std::size_t line_stride = image.size.w * 4;
+	pixels.resize(line_stride * image.size.h);
+
+	while (cinfo.output_scanline < cinfo.output_height) {
+		JSAMPROW row = pixels.data() + cinfo.output_scanline * line_stride;
+		jpeg_read_scanlines(&cinfo, &row, 1);
+	}
+
+	jpeg_finish_decompress(&cinfo);
+	jpeg_destroy_decompress(&cinfo);
+	return true;
+}
+
+static bool decode_png(const std::vector<std::uint8_t>& data, DecodedImage& image) {
+	png_image png{};
+	png.version = PNG_IMAGE_VERSION;
+	if (!png_image_begin_read_from_memory(&png, data.data(), data.size()))
+		return false;
+
+	png.format = PNG_FORMAT_BGRA;
+	image.size = {png.width, png.height};
+	image.pixels.resize(PNG_IMAGE_SIZE(png));
+	if (!png_image_finish_read(&png, nullptr, image.pixels.data(), 0, nullptr)) {
+		png_image_free(&png);
+		return false;
+	}
+
+	// premultiply alpha, as GUID_WICPixelFormat32bppPBGRA
+	for (std::size_t i = 0; i < image.pixels.size(); i += 4) {
+		const auto a = image.pixels[i + 3];
+		if (a != 255)
+			for (auto c = 0; c < 3; c++)
+				image.pixels[i + c] = static_cast<std::uint8_t>((image.pixels[i + c] * a + 127) / 255);
+	}
+
+	return true;
+}
+
+std::shared_ptr<Signature> load_signature(const std::filesystem::path& path) {
+	assert(!path.empty());
+
+	auto signature = std::make_shared<Signature>();
+
+	std::error_code ec;
+	auto file_size = std::filesystem::file_size(path, ec);
+	if (ec || file_size == 0) {
+		signature->status = Signature::Status::open_failed;
+		return signature;
+	}
+
+	std::vector<std::uint8_t> data(static_cast<std::size_t>(file_size));
+	std::ifstream ifs{path, std::ios::binary};
+	ifs.read(reinterpret_cast<char*>(data.data()), data.size());
+	if (ifs.fail()) {
+		signature->status = Signature::Status::open_failed;
+		return signature;
+	}
+	ifs.close();
+
+	signature->file_hash = Hash(data.data(), data.size());
+
+	DecodedImage image;
+	bool decoded = false;
+	const std::uint8_t jpeg_magic[] = {0xff, 0xd8};
+	const std::uint8_t png_magic[] = {0x89, 'P', 'N', 'G'};
+	if (data.size() >= sizeof png_magic && std::equal(jpeg_magic, jpeg_magic + sizeof jpeg_magic, data.begin()))
+		decoded = decode_jpeg(data, image);
+	else if (data.size() >= sizeof png_magic && std::equal(png_magic, png_magic + sizeof png_magic, data.begin()))
+		decoded = decode_png(data, image);
+
+	if (!decoded || image.size.w == 0 || image.size.h == 0) {
+		signature->status = Signature::Status::decode_failed;
+		return signature;
+	}
+
+	calculate_intensities(*signature, image.pixels.data(), image.size, image.size.w * 4);
+	signature->pixel_hash = Hash(image.pixels.data(), image.pixels.size());
+	read_exif_metadata(data.data(), data.size(), *signature);
+
+	return signature;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "signature.h"
+
+#include <filesystem>
+#include <memory>
+
+// Portable (libjpeg and libpng) counterpart of Image for headless use.
+// Reads the file once and computes the file hash, pixel hash, intensities
+// and exif metadata from that single buffer and a single decode. Only jpeg
+// and png files are decoded; other files get Status::decode_failed.
+// As for Image, the pixel hash is of the decoded 32 bpp BGRA pixels.
+std::shared_ptr<Signature> load_signature(const std::filesystem::path& path);
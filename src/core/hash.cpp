@@ -0,0 +1,18 @@
+#include "hash.h"
+
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+Hash Hash::get_chunked_hash(const std::uint8_t* const data, const std::size_t length) {
+	std::vector<Hash> hashes;
+	for (std::size_t offset = 0; offset < length; offset += max_chunk_length)
+		hashes.push_back(Hash(data + offset, std::min(max_chunk_length, length - offset)));
+	return Hash(reinterpret_cast<const std::uint8_t*>(hashes.data()), hashes.size() * sizeof(Hash));
+}
+
+std::wostream& operator<<(std::wostream& os, const Hash hash) {
+	std::wostringstream ss;
+	ss << std::hex << hash.hash[0] << hash.hash[1];
+	return os << ss.str() << std::dec;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "../external/murmurhash3.h"
+
+#include "../shared/assert.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+class Hash {
+public:
+	Hash() : hash{0, 0} {
+	}
+
+	// Data longer than max_chunk_length, which MurmurHash3 cannot take in
+	// one go (its length is an int), is hashed in chunks of that length,
+	// and then the hashes of the chunks are.
+	Hash(const std::uint8_t* const data, const std::size_t length) {
+		assert(data != nullptr);
+		assert(length > 0);
+
+		if (length > max_chunk_length) {
+			*this = get_chunked_hash(data, length);
+			return;
+		}
+
+		#if defined(_M_X64) || defined(__x86_64__) || defined(__aarch64__)
+			MurmurHash3_x64_128(data, static_cast<int>(length), 0, hash);
+		#else
+			MurmurHash3_x86_128(data, static_cast<int>(length), 0, hash);
+		#endif
+
+		assert(hash[0] != 0 && hash[1] != 0);
+	}
+
+	bool operator==(const Hash& rhs) const {
+		return hash[0] == rhs.hash[0] && hash[1] == rhs.hash[1];
+	}
+
+	bool operator<(const Hash& rhs) const {
+		return hash[0] < rhs.hash[0] || (hash[0] == rhs.hash[0] && hash[1] < rhs.hash[1]);
+	}
+
+	friend std::wostream& operator<<(std::wostream& os, const Hash rhs);
+
+	static constexpr std::size_t max_chunk_length = 1 << 30;
+
+private:
+	static Hash get_chunked_hash(const std::uint8_t* const data, const std::size_t length);
+
+	std::uint64_t hash[2];
+};
@@ -0,0 +1,113 @@
+#include "image_table.h"
+
+#include "score.h"
+
+#include "../shared/assert.h"
+
+#include <limits>
+
+ImageTable::ImageTable(const std::size_t n_images, const CompareOptions& options)
+	:
+	oks(n_images),
+	planes(options.quantized ? 0 : n_images),
+	quantized_planes(options.quantized ? n_images : 0),
+	image_sizes(n_images),
+	metadata_directions(n_images),
+	metadata_times(n_images),
+	metadata_make_model_ids(n_images),
+	metadata_camera_ids(n_images),
+	metadata_image_ids(n_images),
+	all_metadata_times(n_images)
+{
+	assert(n_images <= std::numeric_limits<std::uint32_t>::max());
+}
+
+void ImageTable::set(const std::uint32_t id, const Signature& signature) {
+	assert(id < size());
+
+	oks[id] = signature.status == Signature::Status::ok;
+	if (oks[id])
+		set_planes(id, {&signature.intensities, &signature.intensities_cropped_1, &signature.intensities_cropped_2});
+	image_sizes[id] = signature.image_size;
+	set_position(id, signature.metadata_position);
+
+	const auto& times = signature.metadata_times;
+	metadata_times[id] = {times.size() == 1 ? times.front() : TimePoint{}, static_cast<std::uint32_t>(times.size())};
+	if (times.size() > 1)
+		all_metadata_times[id] = times;
+
+	metadata_make_model_ids[id] = get_string_id(signature.metadata_make_model);
+	metadata_camera_ids[id] = get_string_id(signature.metadata_camera_id);
+	metadata_image_ids[id] = get_string_id(signature.metadata_image_id);
+}
+
+void ImageTable::set(const std::uint32_t id, const SignatureView& signature) {
+	assert(id < size());
+
+	oks[id] = signature.status == Signature::Status::ok;
+	if (oks[id])
+		set_planes(id, signature.intensities);
+	image_sizes[id] = signature.image_size;
+	set_position(id, signature.metadata_position);
+
+	auto get_time = [&](const std::size_t i) {
+		return TimePoint{std::chrono::duration_cast<TimePoint::duration>(std::chrono::microseconds{signature.metadata_times[i]})};
+	};
+	const auto n = signature.n_metadata_times;
+	metadata_times[id] = {n == 1 ? get_time(0) : TimePoint{}, static_cast<std::uint32_t>(n)};
+	if (n > 1) {
+		all_metadata_times[id].resize(n);
+		for (std::size_t i = 0; i < n; i++)
+			all_metadata_times[id][i] = get_time(i);
+	}
+
+	metadata_make_model_ids[id] = get_string_id(signature.metadata_make_model);
+	metadata_camera_ids[id] = get_string_id(signature.metadata_camera_id);
+	metadata_image_ids[id] = get_string_id(signature.metadata_image_id);
+}
+
+std::size_t ImageTable::size() const {
+	return oks.size();
+}
+
+std::pair<const ImageTable::TimePoint*, const ImageTable::TimePoint*> ImageTable::get_metadata_times(const std::uint32_t id) const {
+	const auto& t = metadata_times[id];
+	if (t.n == 1)
+		return {&t.time, &t.time + 1};
+	else
+		return {all_metadata_times[id].data(), all_metadata_times[id].data() + all_metadata_times[id].size()};
+}
+
+// only the planes of the options
+void ImageTable::set_planes(const std::uint32_t id, const std::array<const IntensityArray*, 3>& intensities) {
+	for (auto i = 0; i < 3; i++) {
+		const auto p = get_intensity_planes(*intensities[i]);
+		if (!planes.empty())
+			planes[id][i] = p;
+		if (!quantized_planes.empty())
+			quantized_planes[id][i] = quantize(p);
+	}
+}
+
+void ImageTable::set_position(const std::uint32_t id, const Position& position) {
+	metadata_directions[id] = position.x != 0 && position.y != 0 ? get_direction(position) : Direction{0, 0, 0};
+}
+
+std::uint32_t ImageTable::get_string_id(const std::u32string_view s) {
+	if (s.empty())
+		return 0;
+
+	std::lock_guard<std::mutex> lg{strings_mutex};
+	const auto i = string_ids.find(s);
+	if (i != string_ids.end())
+		return i->second;
+	const auto string_id = static_cast<std::uint32_t>(string_ids.size() + 1);
+	string_ids.emplace(s, string_id);
+	return string_id;
+}
+
+// as 32-bit code units, whatever the size of wchar_t, as SignatureView
+std::uint32_t ImageTable::get_string_id(const std::wstring& s) {
+	const std::u32string code_units(s.begin(), s.end());
+	return get_string_id(code_units);
+}
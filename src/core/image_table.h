@@ -0,0 +1,83 @@
+#pragma once
+
+#include "signature.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// What score() needs of the signatures of a set of images, as arrays
+// indexed by image id, so that comparing an image with all others streams
+// through a few dense arrays rather than chasing a pointer to a Signature
+// per pair. Only the planes used by the compare options are computed and
+// kept, and metadata strings are interned: score() only tests them for
+// equality.
+struct ImageTable {
+	using TimePoint = std::chrono::system_clock::time_point;
+
+	// Metadata times of an image: the only one, in place, or the number of
+	// them, which are then in all_metadata_times.
+	struct Times {
+		TimePoint time;
+		std::uint32_t n;
+	};
+
+	// A signature where it is kept other than as a Signature, as in the
+	// file of a SignatureCache, for a row to be set from in place.
+	struct SignatureView {
+		Signature::Status status;
+		PixelSize image_size;
+		std::array<const IntensityArray*, 3> intensities; // if ok
+		const std::int64_t* metadata_times; // microseconds since the epoch
+		std::size_t n_metadata_times;
+		std::u32string_view metadata_make_model; // as code units of std::wstring
+		std::u32string_view metadata_camera_id;
+		std::u32string_view metadata_image_id;
+		Position metadata_position;
+	};
+
+	ImageTable(const std::size_t n_images, const CompareOptions& options);
+
+	// Sets row id to what score() needs of signature: the planes of its
+	// intensities and its metadata. Different rows may be set concurrently.
+	void set(const std::uint32_t id, const Signature& signature);
+
+	// As above, copying and allocating nothing but what the row keeps: the
+	// planes, metadata times if more than one, and strings not seen before.
+	void set(const std::uint32_t id, const SignatureView& signature);
+
+	std::size_t size() const;
+
+	// [begin, end) of the metadata times of image id
+	std::pair<const TimePoint*, const TimePoint*> get_metadata_times(const std::uint32_t id) const;
+
+	// hot, by image id
+	std::vector<std::uint8_t> oks; // Signature::Status::ok
+	std::vector<ImagePlanes<IntensityPlanes>> planes; // unless quantized
+	std::vector<ImagePlanes<QuantizedPlanes>> quantized_planes; // if quantized
+	std::vector<PixelSize> image_sizes;
+	std::vector<Direction> metadata_directions; // {0, 0, 0} if no position
+	std::vector<Times> metadata_times;
+	std::vector<std::uint32_t> metadata_make_model_ids; // 0 if empty
+	std::vector<std::uint32_t> metadata_camera_ids; // 0 if empty
+	std::vector<std::uint32_t> metadata_image_ids; // 0 if empty
+
+	// cold
+	std::vector<std::vector<TimePoint>> all_metadata_times;
+
+private:
+	void set_planes(const std::uint32_t id, const std::array<const IntensityArray*, 3>& intensities);
+	void set_position(const std::uint32_t id, const Position& position);
+	std::uint32_t get_string_id(const std::u32string_view s);
+	std::uint32_t get_string_id(const std::wstring& s);
+
+	std::mutex strings_mutex;
+	std::map<std::u32string, std::uint32_t, std::less<>> string_ids;
+};
@@ -0,0 +1,324 @@
+#include "job.h"
+
+#include "candidates.h"
+
+#include "../shared/assert.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <thread>
+
+ThreadCounts get_default_thread_counts() {
+	const auto n_hardware_threads = std::max(std::thread::hardware_concurrency(), 1u);
+	return {n_hardware_threads, n_hardware_threads};
+}
+
+void Job::decode() {
+	for (;;) {
+		const auto p = position_next_to_load++;
+		if (p >= order.size() || stopped)
+			break;
+		const auto i = order[p];
+
+		load(i, table);
+
+		std::lock_guard<std::mutex> lg{loaded_mutex};
+		loaded[i].store(true, std::memory_order_release);
+		n_loaded++;
+		rows_loaded.notify_all();
+	}
+}
+
+// Whether pairs of category are found by searching the table when the
+// pairs are first asked for, rather than by comparing all pairs.
+static bool is_searched(const int category) {
+	return
+		category == static_cast<int>(Category::time) ||
+		category == static_cast<int>(Category::location);
+}
+
+// Number of tiles of blocks before block, and so the first tile of its
+// row of blocks.
+static std::size_t get_first_tile(const std::size_t block) {
+	return block * (block + 1) / 2;
+}
+
+void Job::work() {
+	const auto n_images = order.size();
+	const auto n_tiles = get_n_tiles();
+	std::vector<std::vector<SignaturePair>> pairs{n_categories};
+
+	// tiles of rows of images compared before are skipped
+	const auto first_tile = get_first_tile(n_compared / tile_size);
+
+	for (;;) {
+		const auto tile = first_tile + index_next_tile++;
+		if (tile >= first_tile + n_tiles)
+			break;
+
+		// tile = block_major * (block_major + 1) / 2 + block_minor
+		auto block_major = static_cast<std::size_t>((std::sqrt(8.0 * tile + 1) - 1) / 2);
+		while (block_major * (block_major + 1) / 2 > tile)
+			block_major--;
+		while ((block_major + 1) * (block_major + 2) / 2 <= tile)
+			block_major++;
+		const auto block_minor = tile - block_major * (block_major + 1) / 2;
+
+		const auto major_begin = block_major * tile_size;
+		const auto major_end = std::min(major_begin + tile_size, n_images);
+		const auto minor_begin = block_minor * tile_size;
+		const auto minor_end = std::min(minor_begin + tile_size, n_images);
+
+		for (auto p = minor_begin; p < minor_end; p++)
+			wait_until_loaded(order[p]);
+		for (auto p = major_begin; p < major_end; p++)
+			wait_until_loaded(order[p]);
+		if (stopped)
+			return;
+
+		std::size_t n_pairs = 0;
+		for (auto position_major = std::max(major_begin, n_compared); position_major < major_end; position_major++) {
+			// pairs with the diagonal, which is skipped, to count progress
+			const auto minor_end_row = std::min(minor_end, position_major + 1);
+			n_pairs += minor_end_row - minor_begin;
+
+			if (stopped)
+				return;
+
+			for (auto position_minor = minor_begin; position_minor < minor_end_row; position_minor++) {
+				if (position_minor == position_major)
+					continue;
+
+				// in index order, whatever the order of positions
+				const auto index_1 = std::min(order[position_minor], order[position_major]);
+				const auto index_2 = std::max(order[position_minor], order[position_major]);
+
+				auto signatures_ok =
+					table.oks[index_1] &&
+					table.oks[index_2];
+				if (!signatures_ok)
+					continue;
+
+				// left to add_image_id_pairs()
+				const auto image_id = table.metadata_image_ids[index_1];
+				if (image_id != 0 && image_id == table.metadata_image_ids[index_2])
+					continue;
+
+				auto s = score(table, index_1, index_2, options);
+
+				// add image pairs to relevant image pair categories
+				for (auto c = 0; c < n_categories; c++)
+					if (!is_searched(c) && s.distances[c] != std::numeric_limits<float>::max())
+						pairs[c].push_back({index_1, index_2, s.distances[c]});
+			}
+		}
+
+		n_pairs_completed += n_pairs;
+		n_tiles_completed++;
+	}
+
+	// images compared before are in no tile claimed, but still needed in
+	// the table
+	for (std::size_t p = 0; p < n_images; p++)
+		wait_until_loaded(order[p]);
+	if (stopped)
+		return;
+
+	for (auto& p : pairs)
+		std::sort(p.begin(), p.end());
+
+	std::lock_guard<std::mutex> lg{pairs_mutex};
+	for (auto c = 0; c < n_categories; c++)
+		pair_runs[c].push_back(std::move(pairs[c]));
+}
+
+// Merges sorted runs into one sorted vector. The output is split into
+// ranges bounded by pairs sampled from the longest run, and each range is
+// merged from the matching parts of all runs by a thread of its own.
+static std::vector<SignaturePair> merge_runs(const std::vector<std::vector<SignaturePair>>& runs, const unsigned n_threads) {
+	std::size_t n_pairs = 0;
+	std::size_t longest = 0;
+	for (std::size_t r = 0; r < runs.size(); r++) {
+		n_pairs += runs[r].size();
+		if (runs[r].size() > runs[longest].size())
+			longest = r;
+	}
+
+	std::vector<SignaturePair> merged(n_pairs);
+	if (n_pairs == 0)
+		return merged;
+
+	// bounds[p][r]: index in run r of the first pair of range p
+	const auto n_ranges = std::min<std::size_t>(n_threads, runs[longest].size());
+	std::vector<std::vector<std::size_t>> bounds(n_ranges + 1, std::vector<std::size_t>(runs.size()));
+	for (std::size_t r = 0; r < runs.size(); r++)
+		bounds[n_ranges][r] = runs[r].size();
+	for (std::size_t p = 1; p < n_ranges; p++) {
+		const auto& splitter = runs[longest][runs[longest].size() * p / n_ranges];
+		for (std::size_t r = 0; r < runs.size(); r++)
+			bounds[p][r] = std::lower_bound(runs[r].begin(), runs[r].end(), splitter) - runs[r].begin();
+	}
+
+	auto merge_range = [&](const std::size_t p) {
+		auto out = merged.begin();
+		for (auto b : bounds[p])
+			out += b;
+
+		// min-heap of the remaining parts of the runs, by their first pair
+		using Part = std::pair<const SignaturePair*, const SignaturePair*>;
+		auto greater = [](const Part& lhs, const Part& rhs) { return *rhs.first < *lhs.first; };
+		std::vector<Part> heap;
+		for (std::size_t r = 0; r < runs.size(); r++)
+			if (bounds[p][r] != bounds[p + 1][r])
+				heap.push_back({runs[r].data() + bounds[p][r], runs[r].data() + bounds[p + 1][r]});
+		std::make_heap(heap.begin(), heap.end(), greater);
+
+		while (!heap.empty()) {
+			std::pop_heap(heap.begin(), heap.end(), greater);
+			auto& part = heap.back();
+			*out++ = *part.first++;
+			if (part.first == part.second)
+				heap.pop_back();
+			else
+				std::push_heap(heap.begin(), heap.end(), greater);
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (std::size_t p = 1; p < n_ranges; p++)
+		threads.push_back(std::thread(merge_range, p));
+	merge_range(0);
+	for (auto& thread : threads)
+		thread.join();
+
+	return merged;
+}
+
+std::size_t Job::get_tile_size(const CompareOptions& options) {
+	const std::size_t cache_size = 512 * 1024;
+	const auto row_size = options.quantized
+		? sizeof(ImagePlanes<QuantizedPlanes>)
+		: sizeof(ImagePlanes<IntensityPlanes>);
+	return std::clamp<std::size_t>(cache_size / 2 / row_size, 16, 1024);
+}
+
+Job::Job(const std::size_t n_images, const Loader& load, const CompareOptions& options, ComparedPairs compared)
+	:
+	load{load},
+	options{options},
+	tile_size{get_tile_size(options)},
+	table{n_images, options},
+	loaded(n_images)
+{
+	assert(compared.images.empty() || compared.images.size() == n_images);
+	for (std::uint32_t i = 0; i < compared.images.size(); i++)
+		if (compared.images[i])
+			order.push_back(i);
+	n_compared = order.size();
+	for (std::uint32_t i = 0; i < n_images; i++)
+		if (compared.images.empty() || !compared.images[i])
+			order.push_back(i);
+	compared_images = std::move(compared.images);
+
+	for (auto c = 0; c < n_categories; c++)
+		if (!is_searched(c) && !compared.pair_categories[c].empty())
+			pair_runs[c].push_back(std::move(compared.pair_categories[c]));
+}
+
+void Job::stop() {
+	std::lock_guard<std::mutex> lg{loaded_mutex};
+	stopped = true;
+	rows_loaded.notify_all();
+}
+
+bool Job::is_stopped() const {
+	return stopped;
+}
+
+void Job::wait_until_loaded(const std::size_t index) {
+	if (loaded[index].load(std::memory_order_acquire))
+		return;
+
+	std::unique_lock<std::mutex> ul{loaded_mutex};
+	rows_loaded.wait(ul, [&] { return loaded[index].load(std::memory_order_acquire) || stopped; });
+}
+
+float Job::get_progress() const {
+	const auto n_pairs = order.size() * (1 + order.size()) / 2 - n_compared * (1 + n_compared) / 2;
+	return n_pairs == 0 ? 1.0f : static_cast<float>(n_pairs_completed) / n_pairs;
+}
+
+bool Job::is_completed() const {
+	return n_tiles_completed == get_n_tiles() && n_loaded == order.size();
+}
+
+std::vector<std::vector<SignaturePair>>& Job::get_pair_categories() {
+	assert(is_completed() || stopped);
+
+	if (!pairs_merged) {
+		const auto n_threads = std::max(std::thread::hardware_concurrency(), 1u);
+		add_image_id_pairs(n_threads);
+		for (auto c = 0; c < n_categories; c++) {
+			if (is_searched(c)) {
+				pair_categories[c] = c == static_cast<int>(Category::time)
+					? find_time_pairs(table)
+					: find_location_pairs(table);
+				std::sort(pair_categories[c].begin(), pair_categories[c].end());
+			} else if (pair_runs[c].size() == 1) {
+				pair_categories[c] = std::move(pair_runs[c].front());
+			} else {
+				pair_categories[c] = merge_runs(pair_runs[c], n_threads);
+			}
+			pair_runs[c].clear();
+		}
+		pairs_merged = true;
+	}
+
+	return pair_categories;
+}
+
+void Job::add_image_id_pairs(const unsigned n_threads) {
+	auto image_id_pairs = find_image_id_pairs(table);
+	if (!compared_images.empty()) {
+		image_id_pairs.erase(std::remove_if(image_id_pairs.begin(), image_id_pairs.end(), [this](const std::pair<std::uint32_t, std::uint32_t>& p) {
+			return compared_images[p.first] && compared_images[p.second];
+		}), image_id_pairs.end());
+	}
+	if (image_id_pairs.empty())
+		return;
+
+	// a range of the pairs per thread, into runs of its own
+	const auto n_ranges = std::min<std::size_t>(n_threads, image_id_pairs.size());
+	std::vector<std::vector<std::vector<SignaturePair>>> runs(n_ranges, std::vector<std::vector<SignaturePair>>(n_categories));
+	auto score_range = [&](const std::size_t r) {
+		const auto begin = image_id_pairs.size() * r / n_ranges;
+		const auto end = image_id_pairs.size() * (r + 1) / n_ranges;
+		for (auto p = begin; p < end; p++) {
+			const auto [index_1, index_2] = image_id_pairs[p];
+			const auto s = score(table, index_1, index_2, options);
+			for (auto c = 0; c < n_categories; c++)
+				if (!is_searched(c) && s.distances[c] != std::numeric_limits<float>::max())
+					runs[r][c].push_back({index_1, index_2, s.distances[c]});
+		}
+		for (auto& run : runs[r])
+			std::sort(run.begin(), run.end());
+	};
+
+	std::vector<std::thread> threads;
+	for (std::size_t r = 1; r < n_ranges; r++)
+		threads.push_back(std::thread(score_range, r));
+	score_range(0);
+	for (auto& thread : threads)
+		thread.join();
+
+	for (auto& run : runs)
+		for (auto c = 0; c < n_categories; c++)
+			if (!run[c].empty())
+				pair_runs[c].push_back(std::move(run[c]));
+}
+
+std::size_t Job::get_n_tiles() const {
+	const auto n_blocks = (order.size() + tile_size - 1) / tile_size;
+	return get_first_tile(n_blocks) - get_first_tile(n_compared / tile_size);
+}
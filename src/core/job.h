@@ -0,0 +1,118 @@
+#pragma once
+
+#include "image_table.h"
+#include "score.h"
+#include "signature.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// Images compared with each other by an earlier job, by index, and their
+// pairs per category, sorted.
+struct ComparedPairs {
+	std::vector<std::uint8_t> images; // empty if none
+	std::vector<std::vector<SignaturePair>> pair_categories{n_categories};
+};
+
+// Numbers of threads to run Job::decode() and Job::work() on.
+struct ThreadCounts {
+	unsigned decode;
+	unsigned compare;
+};
+
+// One thread of each stage per hardware thread. Fewer decoding threads
+// may do as well when decoding is bound by reading the files, as from a
+// slow or network drive.
+ThreadCounts get_default_thread_counts();
+
+// Compares all pairs of n_images signatures, in two stages that run on
+// any number of threads each, concurrently: decode() has the loader set
+// the rows of an ImageTable, which is all that is compared, in index
+// order, and work() compares them. The loader may set a row from a
+// Signature, which it may then keep or drop, or straight from where the
+// signature is kept, as SignatureCache does. Comparing threads claim
+// square tiles of the triangular pair space, sized to keep the images of a
+// tile in cache, with an atomic counter, so no lock is taken per pair, and
+// block rather than spin while the rows of a tile are still being loaded.
+// Each work() call collects its pairs in buffers of its own and hands them
+// over, sorted, when it returns; they are merged once, in parallel, when
+// first asked for. The time and location categories are not taken from
+// the pairs compared but found then by find_time_pairs() and
+// find_location_pairs(). Both return when there is no more work for their
+// stage. Pairs of images with equal metadata image ids, which score() puts
+// in the combined category whatever else they differ in, are not compared
+// in the tiles either but joined by find_image_id_pairs() and scored then,
+// so that they are never missed by whatever skips pairs in the tiles.
+//
+// Pairs of images compared by an earlier job, as on a rescan, may be
+// given instead of being compared again (but those of the searched
+// categories are found again). Images are then loaded and compared in an
+// order of their own, those compared before first, and only the tiles of
+// rows of other images are claimed, so the work is proportional to the
+// number of other images rather than to the number of all. All images are
+// still loaded into the table, whose time and location pairs are searched.
+class Job {
+public:
+	// Sets row id of table to the signature of image id. Called concurrently
+	// for different images.
+	using Loader = std::function<void(const std::uint32_t id, ImageTable& table)>;
+
+	Job(const std::size_t n_images, const Loader& load, const CompareOptions& options = {}, ComparedPairs compared = {});
+
+	void decode();
+	void work();
+
+	// Makes decode() and work() return as soon as possible.
+	void stop();
+	bool is_stopped() const;
+
+	float get_progress() const;
+	bool is_completed() const;
+
+	// Sorted pairs per category (see Category), once all work is done.
+	std::vector<std::vector<SignaturePair>>& get_pair_categories();
+
+	// Images per tile side, so that the hot table rows of the two blocks of
+	// a tile fit in a typical L2 cache.
+	static std::size_t get_tile_size(const CompareOptions& options);
+
+private:
+	void wait_until_loaded(const std::size_t index);
+	std::size_t get_n_tiles() const;
+
+	// Adds a run per category of the pairs of find_image_id_pairs() but
+	// those of images compared before, scored on n_threads threads.
+	void add_image_id_pairs(const unsigned n_threads);
+
+	const Loader load;
+	const CompareOptions options;
+	const std::size_t tile_size;
+	ImageTable table;
+	std::vector<std::uint32_t> order; // image index by position, compared before first
+	std::size_t n_compared = 0;
+	std::vector<std::uint8_t> compared_images; // by image index, empty if none
+
+	std::atomic<bool> stopped = false;
+
+	std::vector<std::atomic<bool>> loaded; // by image index
+	std::atomic<std::size_t> position_next_to_load = 0;
+	std::atomic<std::size_t> n_loaded = 0;
+	std::atomic<std::size_t> index_next_tile = 0;
+	std::atomic<std::size_t> n_tiles_completed = 0;
+	std::atomic<std::size_t> n_pairs_completed = 0;
+
+	std::mutex loaded_mutex;
+	std::condition_variable rows_loaded;
+
+	std::mutex pairs_mutex;
+	std::vector<std::vector<std::vector<SignaturePair>>> pair_runs{n_categories}; // sorted, one per work() call
+	std::vector<std::vector<SignaturePair>> pair_categories{n_categories};
+	bool pairs_merged = false;
+};
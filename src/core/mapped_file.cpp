@@ -0,0 +1,109 @@
+#include "mapped_file.h"
+
+#include <utility>
+
+#ifdef _WIN32
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#ifndef NOMINMAX
+		#define NOMINMAX
+	#endif
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+// The file and mapping handles are closed as soon as the view exists,
+// which keeps the file mapped on its own.
+MappedFile::MappedFile(const std::filesystem::path& path) {
+	#ifdef _WIN32
+		const auto file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return;
+		LARGE_INTEGER size;
+		if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+			if (const auto mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr)) {
+				if (const auto view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)) {
+					data_ = static_cast<const std::uint8_t*>(view);
+					size_ = static_cast<std::size_t>(size.QuadPart);
+				}
+				CloseHandle(mapping);
+			}
+		}
+		CloseHandle(file);
+	#else
+		const auto file = open(path.c_str(), O_RDONLY);
+		if (file == -1)
+			return;
+		struct stat status;
+		if (fstat(file, &status) == 0 && status.st_size > 0) {
+			const auto view = mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_SHARED, file, 0);
+			if (view != MAP_FAILED) {
+				data_ = static_cast<const std::uint8_t*>(view);
+				size_ = static_cast<std::size_t>(status.st_size);
+			}
+		}
+		close(file);
+	#endif
+}
+
+MappedFile::~MappedFile() {
+	unmap();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+	:
+	data_{std::exchange(other.data_, nullptr)},
+	size_{std::exchange(other.size_, 0)}
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+	if (this != &other) {
+		unmap();
+		data_ = std::exchange(other.data_, nullptr);
+		size_ = std::exchange(other.size_, 0);
+	}
+	return *this;
+}
+
+const std::uint8_t* MappedFile::data() const {
+	return data_;
+}
+
+std::size_t MappedFile::size() const {
+	return size_;
+}
+
+void MappedFile::unmap() {
+	if (data_ == nullptr)
+		return;
+	#ifdef _WIN32
+		UnmapViewOfFile(data_);
+	#else
+		munmap(const_cast<std::uint8_t*>(data_), size_);
+	#endif
+	data_ = nullptr;
+	size_ = 0;
+}
+
+bool flush_file(const std::filesystem::path& path) {
+	#ifdef _WIN32
+		const auto file = CreateFileW(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+		const auto is_flushed = FlushFileBuffers(file) != 0;
+		CloseHandle(file);
+	#else
+		const auto file = open(path.c_str(), O_WRONLY);
+		if (file == -1)
+			return false;
+		const auto is_flushed = fsync(file) == 0;
+		close(file);
+	#endif
+	return is_flushed;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+// Whole file mapped read-only into memory, and so shared through the page
+// cache with other processes that map it. Empty if the file cannot be
+// mapped or is empty. The file may be renamed over while mapped, except on
+// Windows.
+class MappedFile {
+public:
+	MappedFile() = default;
+	explicit MappedFile(const std::filesystem::path& path);
+	~MappedFile();
+
+	MappedFile(MappedFile&& other) noexcept;
+	MappedFile& operator=(MappedFile&& other) noexcept;
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	const std::uint8_t* data() const;
+	std::size_t size() const;
+
+private:
+	void unmap();
+
+	const std::uint8_t* data_ = nullptr;
+	std::size_t size_ = 0;
+};
+
+// Writes what was written to the file at path through to the disk, so that
+// it survives a crash. Returns false if that fails.
+bool flush_file(const std::filesystem::path& path);
@@ -0,0 +1,359 @@
+#include "metadata.h"
+
+#include "../shared/assert.h"
+#include "../shared/trim.h"
+
+#include <algorithm>
+#include <ctime>
+#include <sstream>
+#include <vector>
+
+std::chrono::system_clock::time_point parse_metadata_time(std::wstring s) {
+	bool valid = false;
+	if (s.length() >= std::wstring{L"0000-00-00"}.length()) {
+		valid = true;
+
+		valid &=
+			(s[4] == ':' || s[4] == '-') &&
+			(s[7] == ':' || s[7] == '-');
+
+		if (s.length() >= std::wstring{L"0000-00-00 00:00"}.length())
+			valid &=
+				(s[10] == 'T' || s[10] == ' ') &&
+				(s[13] == ':');
+
+		if (s.length() >= std::wstring{L"0000-00-00 00:00:00"}.length())
+			valid &=
+				(s[16] == ':' || s[16] == '+' || s[16] == '-');
+	}
+
+	if (!valid)
+		return std::chrono::system_clock::time_point::min();
+
+	std::size_t pos;
+
+	pos = s.find_last_of(L'+');
+	if (pos != std::wstring::npos && pos > 15)
+		s.erase(pos);
+
+	pos = s.find_last_of(L'-');
+	if (pos != std::wstring::npos && pos > 15)
+		s.erase(pos);
+
+	tm tm{};
+	std::wistringstream ss{s};
+
+	ss >> tm.tm_year;
+	tm.tm_year -= 1900;
+	ss.ignore(1);
+	ss >> tm.tm_mon;
+	tm.tm_mon -= 1;
+	ss.ignore(1);
+	ss >> tm.tm_mday;
+
+	ss.ignore(1);
+	ss >> tm.tm_hour;
+	ss.ignore(1);
+	ss >> tm.tm_min;
+	ss.ignore(1);
+	ss >> tm.tm_sec;
+
+	tm.tm_isdst = -1;
+
+	auto t = mktime(&tm);
+	if (t == -1)
+		return std::chrono::system_clock::time_point::min();
+	return std::chrono::system_clock::from_time_t(t);
+}
+
+std::wstring normalize_make_model(const std::wstring& make_model) {
+	auto normalized = make_model;
+
+	// replace some common phrases in make/model
+	struct {
+		std::wstring substring;
+		std::wstring substring_replacement;
+	} make_model_replacements[] {
+		{L"NIKON CORPORATION", L"NIKON"} ,
+		{L"EASTMAN KODAK COMPANY", L"KODAK"},
+		{L" ZOOM DIGITAL CAMERA", L""},
+	};
+	for (const auto& r : make_model_replacements) {
+		auto fp = normalized.find(r.substring);
+		if (fp != std::wstring::npos)
+			normalized.replace(fp, r.substring.length(), r.substring_replacement);
+	}
+
+	// remove identical consecutive words
+	std::wistringstream ss{normalized};
+	std::vector<std::wstring> words;
+	std::wstring word;
+	while (ss >> word)
+		words.push_back(word);
+	words.erase(std::unique(words.begin(), words.end()), words.end());
+	normalized = L"";
+	for (const auto& w : words) {
+		if (!normalized.empty())
+			normalized.append(L" ");
+		normalized.append(w);
+	}
+
+	return normalized;
+}
+
+void normalize_metadata_times(std::vector<std::chrono::system_clock::time_point>& times) {
+	sort(times.begin(), times.end());
+	auto new_end = std::unique(times.begin(), times.end());
+	times.erase(new_end, times.end());
+}
+
+// Minimal reader of the tiff structure embedded in the jpeg app1 exif segment.
+class ExifReader {
+public:
+	ExifReader(const std::uint8_t* const data, const std::size_t size) : data{data}, size{size} {
+		if (size < 8)
+			return;
+		if (data[0] == 'I' && data[1] == 'I')
+			little_endian = true;
+		else if (data[0] == 'M' && data[1] == 'M')
+			little_endian = false;
+		else
+			return;
+		valid = read_16(2) == 42;
+	}
+
+	bool is_valid() const {
+		return valid;
+	}
+
+	std::uint32_t get_ifd0_offset() const {
+		return read_32(4);
+	}
+
+	struct Entry {
+		std::uint16_t tag;
+		std::uint16_t type;
+		std::uint32_t count;
+		std::uint32_t value_offset;
+	};
+
+	std::vector<Entry> read_ifd(const std::uint32_t offset) const {
+		std::vector<Entry> entries;
+		if (!valid || offset == 0 || offset > size - 2)
+			return entries;
+
+		auto n_entries = read_16(offset);
+		for (std::uint32_t i = 0; i < n_entries; i++) {
+			auto o = offset + 2 + i * 12;
+			if (o + 12 > size)
+				break;
+
+			Entry e{read_16(o), read_16(o + 2), read_32(o + 4), o + 8};
+			if (e.count == 0 || e.count > size)
+				continue;
+			if (get_type_size(e.type) * e.count > 4)
+				e.value_offset = read_32(o + 8);
+			if (get_type_size(e.type) == 0 || e.value_offset > size || get_type_size(e.type) * e.count > size - e.value_offset)
+				continue;
+			entries.push_back(e);
+		}
+		return entries;
+	}
+
+	std::wstring get_string(const Entry& e) const {
+		if (e.type != type_ascii)
+			return L"";
+		std::wstring s;
+		for (std::uint32_t i = 0; i < e.count && data[e.value_offset + i] != 0; i++)
+			s += static_cast<wchar_t>(data[e.value_offset + i]);
+		return trim(s);
+	}
+
+	std::uint32_t get_integer(const Entry& e) const {
+		if (e.type == type_short)
+			return read_16(e.value_offset);
+		else if (e.type == type_long)
+			return read_32(e.value_offset);
+		else
+			return 0;
+	}
+
+	// degrees + minutes/60 + seconds/3600 from three rationals
+	float get_location(const Entry& e) const {
+		assert(e.count == 3);
+		if (e.type != type_rational || e.count != 3)
+			return 0;
+
+		float values[3];
+		for (std::uint32_t i = 0; i < 3; i++) {
+			auto numerator = read_32(e.value_offset + i * 8);
+			auto denominator = read_32(e.value_offset + i * 8 + 4);
+			values[i] = denominator != 0 ? static_cast<float>(numerator) / denominator : 0;
+		}
+
+		return values[0] + values[1]/60 + values[2]/3600;
+	}
+
+private:
+	static const std::uint16_t type_ascii = 2;
+	static const std::uint16_t type_short = 3;
+	static const std::uint16_t type_long = 4;
+	static const std::uint16_t type_rational = 5;
+
+	const std::uint8_t* const data;
+	const std::size_t size;
+	bool little_endian = true;
+	bool valid = false;
+
+	static std::uint32_t get_type_size(const std::uint16_t type) {
+		switch (type) {
+		case 1: case 2: case 6: case 7: return 1;
+		case 3: case 8: return 2;
+		case 4: case 9: case 11: return 4;
+		case 5: case 10: case 12: return 8;
+		default: return 0;
+		}
+	}
+
+	std::uint16_t read_16(const std::size_t offset) const {
+		if (offset + 2 > size)
+			return 0;
+		if (little_endian)
+			return static_cast<std::uint16_t>(data[offset] | data[offset + 1] << 8);
+		else
+			return static_cast<std::uint16_t>(data[offset] << 8 | data[offset + 1]);
+	}
+
+	std::uint32_t read_32(const std::size_t offset) const {
+		if (offset + 4 > size)
+			return 0;
+		if (little_endian)
+			return
+				static_cast<std::uint32_t>(data[offset + 0]) << 0 |
+				static_cast<std::uint32_t>(data[offset + 1]) << 8 |
+				static_cast<std::uint32_t>(data[offset + 2]) << 16 |
+				static_cast<std::uint32_t>(data[offset + 3]) << 24;
+		else
+			return
+				static_cast<std::uint32_t>(data[offset + 0]) << 24 |
+				static_cast<std::uint32_t>(data[offset + 1]) << 16 |
+				static_cast<std::uint32_t>(data[offset + 2]) << 8 |
+				static_cast<std::uint32_t>(data[offset + 3]) << 0;
+	}
+};
+
+// Returns the tiff structure of the first app1 exif segment of a jpeg file.
+static std::pair<const std::uint8_t*, std::size_t> find_exif(const std::uint8_t* const data, const std::size_t size) {
+	if (size < 4 || data[0] != 0xff || data[1] != 0xd8)
+		return {nullptr, 0};
+
+	std::size_t offset = 2;
+	while (offset + 4 <= size) {
+		if (data[offset] != 0xff)
+			break;
+		auto marker = data[offset + 1];
+		if (marker == 0xff) {
+			offset++;
+			continue;
+		}
+		if (marker == 0xda || marker == 0xd9) // start of scan, end of image
+			break;
+
+		std::size_t length = data[offset + 2] << 8 | data[offset + 3];
+		if (length < 2 || offset + 2 + length > size)
+			break;
+
+		const std::uint8_t exif_header[] = {'E', 'x', 'i', 'f', 0, 0};
+		if (marker == 0xe1 && length >= 2 + sizeof exif_header && std::equal(exif_header, exif_header + sizeof exif_header, data + offset + 4))
+			return {data + offset + 4 + sizeof exif_header, length - 2 - sizeof exif_header};
+
+		offset += 2 + length;
+	}
+
+	return {nullptr, 0};
+}
+
+void read_exif_metadata(const std::uint8_t* const data, const std::size_t size, Signature& signature) {
+	auto [exif_data, exif_size] = find_exif(data, size);
+	if (exif_data == nullptr)
+		return;
+
+	ExifReader reader{exif_data, exif_size};
+	if (!reader.is_valid())
+		return;
+
+	std::uint32_t exif_ifd_offset = 0;
+	std::uint32_t gps_ifd_offset = 0;
+	std::wstring make;
+	std::wstring model;
+	bool model_found = false;
+
+	for (const auto& e : reader.read_ifd(reader.get_ifd0_offset())) {
+		if (e.tag == 271) { // Make
+			make = reader.get_string(e);
+		} else if (e.tag == 272) { // Model
+			model = reader.get_string(e);
+			model_found = true;
+		} else if (e.tag == 306) { // DateTime
+			auto t = parse_metadata_time(reader.get_string(e));
+			if (t > std::chrono::system_clock::time_point::min())
+				signature.metadata_times.push_back(t);
+		} else if (e.tag == 0x8769) {
+			exif_ifd_offset = reader.get_integer(e);
+		} else if (e.tag == 0x8825) {
+			gps_ifd_offset = reader.get_integer(e);
+		}
+	}
+
+	// metadata make and model
+
+	signature.metadata_make_model = make;
+	if (model_found)
+		signature.metadata_make_model += L" " + model;
+	if (!signature.metadata_make_model.empty())
+		signature.metadata_make_model = normalize_make_model(signature.metadata_make_model);
+
+	for (const auto& e : reader.read_ifd(exif_ifd_offset)) {
+		if (e.tag == 36867 || e.tag == 36868) { // DateTimeOriginal, DateTimeDigitized
+			auto t = parse_metadata_time(reader.get_string(e));
+			if (t > std::chrono::system_clock::time_point::min())
+				signature.metadata_times.push_back(t);
+		} else if (e.tag == 42033) { // BodySerialNumber
+			signature.metadata_camera_id = reader.get_string(e);
+		} else if (e.tag == 42016) { // ImageUniqueID
+			signature.metadata_image_id = reader.get_string(e);
+		}
+	}
+
+	normalize_metadata_times(signature.metadata_times);
+
+	// metadata position
+
+	std::wstring latitude_ref;
+	std::wstring longitude_ref;
+	Position position{0, 0};
+	for (const auto& e : reader.read_ifd(gps_ifd_offset)) {
+		if (e.tag == 1)
+			latitude_ref = reader.get_string(e);
+		else if (e.tag == 2)
+			position.y = reader.get_location(e);
+		else if (e.tag == 3)
+			longitude_ref = reader.get_string(e);
+		else if (e.tag == 4)
+			position.x = reader.get_location(e);
+	}
+
+	if (latitude_ref == L"S" || latitude_ref == L"s")
+		position.y *= -1;
+	else if (latitude_ref != L"N" && latitude_ref != L"n")
+		position.y = 0;
+
+	if (longitude_ref == L"W" || longitude_ref == L"w")
+		position.x *= -1;
+	else if (longitude_ref != L"E" && longitude_ref != L"e")
+		position.x = 0;
+
+	if (position.x == 0 || position.y == 0)
+		position = {0, 0}; // TODO: bad way to indicate invalid position
+	signature.metadata_position = position;
+}
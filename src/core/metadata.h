@@ -0,0 +1,22 @@
+#pragma once
+
+#include "signature.h"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Parses xmp dates (YYYY YYYY-MM YYYY-MM-DD YYYY-MM-DDThh:mmTZD
+// YYYY-MM-DDThh:mm:ssTZD YYYY-MM-DDThh:mm:ss.sTZD) and tiff/exif dates
+// (YYYY:MM:DD HH:MM:SS). Returns time_point::min() if invalid.
+std::chrono::system_clock::time_point parse_metadata_time(std::wstring s);
+
+// Replaces some common phrases and removes identical consecutive words.
+std::wstring normalize_make_model(const std::wstring& make_model);
+
+// Sorts and removes duplicate times.
+void normalize_metadata_times(std::vector<std::chrono::system_clock::time_point>& times);
+
+// Reads the exif metadata (times, make and model, camera id, image id
+// and position) of a jpeg file into signature. Xmp metadata is not read.
+void read_exif_metadata(const std::uint8_t* const data, const std::size_t size, Signature& signature);
@@ -0,0 +1,49 @@
+#include "paths.h"
+
+#include <algorithm>
+#include <cwctype>
+#include <string>
+#include <system_error>
+
+bool is_image(const std::filesystem::path& path) {
+	const std::wstring extensions[] {
+		L".jpg", L".jpe", L".jpeg",
+		L".png", L".gif", L".bmp",
+		L".tif", L".tiff",
+		L".jxr", L".hdp", L".wdp"};
+
+	auto extension = path.extension().wstring();
+	std::transform(extension.begin(), extension.end(), extension.begin(),
+		[](const wchar_t c) { return static_cast<wchar_t>(std::towlower(c)); });
+
+	return std::find(std::begin(extensions), std::end(extensions), extension) != std::end(extensions);
+}
+
+static bool is_hidden(const std::filesystem::path& path) {
+	auto filename = path.filename().native();
+	return !filename.empty() && filename[0] == '.';
+}
+
+std::vector<std::filesystem::path> find_images(const std::vector<std::filesystem::path>& paths) {
+	std::vector<std::filesystem::path> image_paths;
+	auto items = paths;
+
+	while (!items.empty()) {
+		auto item = items.back();
+		items.pop_back();
+
+		std::error_code ec;
+		if (std::filesystem::is_directory(item, ec)) {
+			for (std::filesystem::directory_iterator i{item, ec}, end; !ec && i != end; i.increment(ec))
+				if (!is_hidden(i->path()))
+					items.push_back(i->path());
+		} else if (std::filesystem::is_regular_file(item, ec) && is_image(item)) {
+			image_paths.push_back(item);
+		}
+	}
+
+	std::sort(image_paths.begin(), image_paths.end());
+	image_paths.erase(std::unique(image_paths.begin(), image_paths.end()), image_paths.end());
+
+	return image_paths;
+}
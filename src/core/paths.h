@@ -0,0 +1,10 @@
+#pragma once
+
+#include <filesystem>
+#include <vector>
+
+bool is_image(const std::filesystem::path& path);
+
+// Image paths found by recursively searching paths (folders or files),
+// sorted and without duplicates. Hidden files and folders are skipped.
+std::vector<std::filesystem::path> find_images(const std::vector<std::filesystem::path>& paths);
@@ -0,0 +1,274 @@
+#include "scan_state.h"
+
+#include "../shared/assert.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <type_traits>
+
+namespace {
+	// Followed by n_images ImageEntry, their paths (UTF-8) and then
+	// n_pairs[c] SignaturePair per category c.
+	struct Header {
+		char magic[8];
+		std::uint32_t version;
+		std::uint32_t byte_order;
+		std::uint32_t canonical_orientation;
+		std::uint32_t quantized;
+		std::uint64_t n_images;
+		std::uint64_t n_pairs[n_categories];
+		std::uint64_t paths_size;
+		std::uint64_t file_size;
+		Hash body_hash; // of the rest of the file (see get_body_hash())
+		Hash hash; // of the above
+	};
+
+	struct ImageEntry {
+		FileStamp stamp;
+		std::uint64_t path_size;
+		std::uint32_t has_stamp;
+		std::uint32_t reserved;
+	};
+
+	// without padding, which would be hashed or written
+	static_assert(sizeof(Header) == 8 + 4 * 4 + 8 + 8 * n_categories + 8 + 8 + 16 + 16);
+	static_assert(sizeof(ImageEntry) == 16 + 8 + 4 + 4);
+	static_assert(sizeof(SignaturePair) == 4 + 4 + 4);
+	static_assert(std::is_trivially_copyable_v<SignaturePair>);
+}
+
+static const char state_magic[8] = {'p', 'i', 'x', 'i', 'p', 'l', 'e', 's'};
+static const std::uint32_t state_byte_order = 0x01020304;
+
+static Hash get_header_hash(const Header& header) {
+	return Hash(reinterpret_cast<const std::uint8_t*>(&header), offsetof(Header, hash));
+}
+
+// Hash of the sections following the header: the hash of the hashes of
+// those not empty, as Hash takes no empty data.
+static Hash get_body_hash(
+	const std::vector<ImageEntry>& entries,
+	const std::string& path_data,
+	const std::vector<std::vector<SignaturePair>>& pair_categories
+) {
+	std::vector<Hash> hashes;
+	auto add = [&](const void* const data, const std::size_t size) {
+		if (size > 0)
+			hashes.push_back(Hash(static_cast<const std::uint8_t*>(data), size));
+	};
+	add(entries.data(), entries.size() * sizeof(ImageEntry));
+	add(path_data.data(), path_data.size());
+	for (const auto& pairs : pair_categories)
+		add(pairs.data(), pairs.size() * sizeof(SignaturePair));
+
+	if (hashes.empty())
+		return Hash{};
+	return Hash(reinterpret_cast<const std::uint8_t*>(hashes.data()), hashes.size() * sizeof(Hash));
+}
+
+static std::filesystem::path get_path(const std::string& utf8) {
+	#ifdef __cpp_char8_t
+		return std::u8string{utf8.begin(), utf8.end()};
+	#else
+		return std::filesystem::u8path(utf8);
+	#endif
+}
+
+// Whether pairs are sorted and of different images of n_images.
+static bool is_valid(const std::vector<SignaturePair>& pairs, const std::size_t n_images) {
+	const auto valid = std::all_of(pairs.begin(), pairs.end(), [n_images](const SignaturePair& p) {
+		return p.index_1 < p.index_2 && p.index_2 < n_images;
+	});
+	return valid && std::is_sorted(pairs.begin(), pairs.end());
+}
+
+bool ScanState::load(const std::filesystem::path& path) {
+	std::error_code ec;
+	const auto file_size = std::filesystem::file_size(path, ec);
+	if (ec)
+		return false;
+
+	std::ifstream ifs{path, std::ios::binary};
+	auto read = [&](void* const data, const std::size_t size) {
+		return static_cast<bool>(ifs.read(static_cast<char*>(data), size));
+	};
+
+	Header header{};
+	if (
+		!read(&header, sizeof header) ||
+		!std::equal(std::begin(state_magic), std::end(state_magic), std::begin(header.magic)) ||
+		header.version != version ||
+		header.byte_order != state_byte_order ||
+		!(get_header_hash(header) == header.hash) ||
+		header.file_size != file_size)
+		return false;
+
+	// sizes are checked against the file size before anything is allocated
+	auto size = sizeof header + header.paths_size;
+	if (header.n_images > file_size / sizeof(ImageEntry) || header.paths_size > file_size)
+		return false;
+	size += header.n_images * sizeof(ImageEntry);
+	for (auto n : header.n_pairs) {
+		if (n > file_size / sizeof(SignaturePair))
+			return false;
+		size += n * sizeof(SignaturePair);
+	}
+	if (size != file_size)
+		return false;
+
+	const auto n_images = static_cast<std::size_t>(header.n_images);
+	std::vector<ImageEntry> entries(n_images);
+	std::string path_data(static_cast<std::size_t>(header.paths_size), '\0');
+	if (!read(entries.data(), n_images * sizeof(ImageEntry)) || !read(path_data.data(), path_data.size()))
+		return false;
+
+	ScanState state;
+	state.options.canonical_orientation = header.canonical_orientation != 0;
+	state.options.quantized = header.quantized != 0;
+	std::size_t offset = 0;
+	for (const auto& entry : entries) {
+		if (entry.path_size > path_data.size() - offset)
+			return false;
+		const auto p = path_data.substr(offset, static_cast<std::size_t>(entry.path_size));
+		offset += p.size();
+		state.paths.push_back(get_path(p));
+		if (state.paths.size() > 1 && !(state.paths[state.paths.size() - 2] < state.paths.back()))
+			return false;
+		state.stamps.push_back(entry.has_stamp ? std::optional<FileStamp>{entry.stamp} : std::nullopt);
+	}
+	if (offset != path_data.size())
+		return false;
+
+	for (auto c = 0; c < n_categories; c++) {
+		auto& pairs = state.pair_categories[c];
+		pairs.resize(static_cast<std::size_t>(header.n_pairs[c]));
+		if (!read(pairs.data(), pairs.size() * sizeof(SignaturePair)) || !is_valid(pairs, n_images))
+			return false;
+	}
+	if (!(get_body_hash(entries, path_data, state.pair_categories) == header.body_hash))
+		return false;
+
+	*this = std::move(state);
+	return true;
+}
+
+bool ScanState::save(const std::filesystem::path& path) const {
+	assert(stamps.size() == paths.size());
+	assert(std::is_sorted(paths.begin(), paths.end()));
+
+	std::error_code ec;
+	if (path.has_parent_path())
+		std::filesystem::create_directories(path.parent_path(), ec);
+
+	std::vector<ImageEntry> entries;
+	std::string path_data;
+	for (std::size_t i = 0; i < paths.size(); i++) {
+		const auto p = paths[i].u8string();
+		path_data.append(p.begin(), p.end());
+		ImageEntry entry{};
+		entry.stamp = stamps[i].value_or(FileStamp{0, 0});
+		entry.path_size = p.size();
+		entry.has_stamp = stamps[i].has_value();
+		entries.push_back(entry);
+	}
+
+	Header header{};
+	std::copy(std::begin(state_magic), std::end(state_magic), std::begin(header.magic));
+	header.version = version;
+	header.byte_order = state_byte_order;
+	header.canonical_orientation = options.canonical_orientation;
+	header.quantized = options.quantized;
+	header.n_images = paths.size();
+	header.paths_size = path_data.size();
+	header.file_size = sizeof header + entries.size() * sizeof(ImageEntry) + path_data.size();
+	for (auto c = 0; c < n_categories; c++) {
+		header.n_pairs[c] = pair_categories[c].size();
+		header.file_size += pair_categories[c].size() * sizeof(SignaturePair);
+	}
+	header.body_hash = get_body_hash(entries, path_data, pair_categories);
+	header.hash = get_header_hash(header);
+
+	auto temporary_path = path;
+	temporary_path += ".tmp";
+	{
+		std::ofstream ofs{temporary_path, std::ios::binary | std::ios::trunc};
+		auto write = [&](const void* const data, const std::size_t size) {
+			ofs.write(static_cast<const char*>(data), size);
+		};
+		write(&header, sizeof header);
+		write(entries.data(), entries.size() * sizeof(ImageEntry));
+		write(path_data.data(), path_data.size());
+		for (const auto& pairs : pair_categories)
+			write(pairs.data(), pairs.size() * sizeof(SignaturePair));
+
+		ofs.flush();
+		if (!ofs) {
+			ofs.close();
+			std::filesystem::remove(temporary_path, ec);
+			return false;
+		}
+	}
+
+	std::filesystem::rename(temporary_path, path, ec);
+	if (ec) {
+		std::filesystem::remove(temporary_path, ec);
+		return false;
+	}
+	return true;
+}
+
+ComparedPairs get_compared_pairs(
+	const ScanState& state,
+	const std::vector<std::filesystem::path>& paths,
+	const std::vector<std::optional<FileStamp>>& stamps,
+	const CompareOptions& options
+) {
+	assert(stamps.size() == paths.size());
+	assert(std::is_sorted(paths.begin(), paths.end()));
+
+	ComparedPairs compared;
+	if (
+		state.options.canonical_orientation != options.canonical_orientation ||
+		state.options.quantized != options.quantized)
+		return compared;
+
+	// index in paths of each image of state, if unchanged, by merging the
+	// two sorted path lists
+	const auto none = std::numeric_limits<std::uint32_t>::max();
+	std::vector<std::uint32_t> indices(state.paths.size(), none);
+	compared.images.resize(paths.size());
+	std::size_t n_unchanged = 0;
+	for (std::size_t i = 0, j = 0; i < state.paths.size() && j < paths.size();) {
+		if (state.paths[i] < paths[j]) {
+			i++;
+		} else if (paths[j] < state.paths[i]) {
+			j++;
+		} else {
+			if (state.stamps[i] && stamps[j] && *state.stamps[i] == *stamps[j]) {
+				indices[i] = static_cast<std::uint32_t>(j);
+				compared.images[j] = true;
+				n_unchanged++;
+			}
+			i++;
+			j++;
+		}
+	}
+	if (n_unchanged == 0)
+		return {};
+
+	// indices keep their order, and so the pairs theirs
+	for (auto c = 0; c < n_categories; c++) {
+		for (const auto& p : state.pair_categories[c]) {
+			const auto index_1 = indices[p.index_1];
+			const auto index_2 = indices[p.index_2];
+			if (index_1 != none && index_2 != none)
+				compared.pair_categories[c].push_back({index_1, index_2, p.distance});
+		}
+	}
+
+	return compared;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "job.h"
+#include "score.h"
+#include "signature.h"
+#include "signature_cache.h"
+
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+// Images and pairs found by a scan, kept on disk so that scanning again
+// compares only images new or changed since (see get_compared_pairs()),
+// and so that the pairs can be shown again without scanning at all. Pairs
+// are kept as they are in memory, 12 bytes each, so that loading is
+// little more than reading the file.
+// The file is only ever replaced whole, by writing a new file and renaming
+// it over the old one, and is ignored if of another version or damaged
+// anywhere, which a hash of the whole file tells.
+struct ScanState {
+	// Bump when the format or the computation of pairs changes.
+	static const std::uint32_t version = 2;
+
+	CompareOptions options;
+	std::vector<std::filesystem::path> paths; // sorted
+	std::vector<std::optional<FileStamp>> stamps; // by image index, none if not read
+	std::vector<std::vector<SignaturePair>> pair_categories{n_categories};
+
+	// Reads the file at path. Returns false, leaving this as it was, if
+	// there is none or it cannot be used.
+	bool load(const std::filesystem::path& path);
+
+	// Writes the file at path, creating its folder. Returns false, leaving
+	// any previous file as it was, if that fails.
+	bool save(const std::filesystem::path& path) const;
+};
+
+// Images of sorted paths, with stamps, that are in state with the same
+// stamps, and their pairs in state, reindexed to paths, if state was
+// compared with options. Pairs of images removed or changed since are
+// dropped.
+ComparedPairs get_compared_pairs(
+	const ScanState& state,
+	const std::vector<std::filesystem::path>& paths,
+	const std::vector<std::optional<FileStamp>>& stamps,
+	const CompareOptions& options
+);
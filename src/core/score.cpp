@@ -0,0 +1,222 @@
+#include "score.h"
+
+#include "../shared/assert.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace std::chrono_literals;
+
+Direction get_direction(const Position& position) {
+	const auto pi = 3.14159265358979323846;
+	const auto longitude = position.x * (pi / 180);
+	const auto latitude = position.y * (pi / 180);
+	return {
+		static_cast<float>(std::cos(latitude) * std::cos(longitude)),
+		static_cast<float>(std::cos(latitude) * std::sin(longitude)),
+		static_cast<float>(std::sin(latitude))};
+}
+
+float earth_distance(const Direction& d1, const Direction& d2) {
+	const auto dx = d1.x - d2.x;
+	const auto dy = d1.y - d2.y;
+	const auto dz = d1.z - d2.z;
+	const auto chord = std::sqrt(dx*dx + dy*dy + dz*dz);
+	return 2 * earth_mean_radius * std::asin(std::min(chord / 2, 1.0f));
+}
+
+float earth_distance(const Position& p1, const Position& p2) {
+	assert(p1.x >= -180 && p1.x <= 180);
+	assert(p2.x >= -180 && p2.x <= 180);
+	assert(p1.y >= -90 && p1.y <= 90);
+	assert(p2.y >= -90 && p2.y <= 90);
+
+	auto d = earth_distance(get_direction(p1), get_direction(p2));
+
+	assert(d >= 0);
+	assert(d <= earth_mean_radius * 3.1416f);
+
+	return d;
+}
+
+template<typename Times>
+static std::chrono::system_clock::duration time_distance(const Times& times_1, const Times& times_2) {
+	auto duration_min = std::chrono::system_clock::duration::max();
+	auto t1 = times_1.first;
+	auto t2 = times_2.first;
+	while (t1 != times_1.second && t2 != times_2.second) {
+		duration_min = std::min(duration_min, std::chrono::abs(*t1 - *t2));
+		if (*t1 < *t2)
+			t1++;
+		else
+			t2++;
+	}
+	return duration_min;
+}
+
+std::chrono::system_clock::duration time_distance(const ImageInfo& info_1, const ImageInfo& info_2) {
+	const auto& t1 = info_1.metadata_times;
+	const auto& t2 = info_2.metadata_times;
+	return time_distance(std::make_pair(t1.begin(), t1.end()), std::make_pair(t2.begin(), t2.end()));
+}
+
+static float location_distance(const Position& p1, const Position& p2) {
+	if (p1.x != 0 && p1.y != 0 && p2.x != 0 && p2.y != 0)
+		return earth_distance(p1, p2);
+	else
+		return std::numeric_limits<float>::max();
+}
+
+float location_distance(const ImageInfo& info_1, const ImageInfo& info_2) {
+	return location_distance(info_1.metadata_position, info_2.metadata_position);
+}
+
+// Adds the combined distance of a metadata string pair, given as ids with
+// 0 for an empty string.
+static void score_string_ids(
+	const std::uint32_t id_1,
+	const std::uint32_t id_2,
+	const float both_set_equal,
+	const float one_set,
+	const float both_set_different,
+	float& distance_combined
+) {
+	if (id_1 == id_2) {
+		if (id_1 == 0)
+			distance_combined += 0; // both empty
+		else
+			distance_combined += both_set_equal;
+	} else {
+		if (id_1 == 0 || id_2 == 0)
+			distance_combined += one_set;
+		else
+			distance_combined += both_set_different;
+	}
+}
+
+Score score(const ImageTable& table, const std::uint32_t id_1, const std::uint32_t id_2, const CompareOptions& options) {
+	Score score;
+	std::fill(std::begin(score.distances), std::end(score.distances), std::numeric_limits<float>::max());
+
+	auto distance_combined = 0.0f;
+	auto distance_combined_min = 0.0f;
+	auto distance_combined_max = 0.0f;
+
+	// TODO: Magic numbers related to image pair similarity scoring below; should be refactored once it has stabilized.
+
+	// score time
+	auto distance_time = std::numeric_limits<float>::max();
+	auto n_images_with_metadata_times =
+		(table.metadata_times[id_1].n != 0) +
+		(table.metadata_times[id_2].n != 0);
+	if (n_images_with_metadata_times == 1) {
+		distance_combined += 1;
+	} else if (n_images_with_metadata_times == 2) {
+		auto duration_min = time_distance(table.get_metadata_times(id_1), table.get_metadata_times(id_2));
+		assert(duration_min != std::chrono::system_clock::duration::max());
+
+		if (duration_min != std::chrono::system_clock::duration::max())
+			distance_time = std::chrono::duration<float>(duration_min).count();
+
+		if (duration_min < 2*24h)
+			distance_combined += -5 * (1 - std::chrono::duration<float>(duration_min).count() / (2*24*3600));
+		else if (duration_min > 20*24h)
+			distance_combined += 5;
+	}
+	distance_combined_min += -5;
+	distance_combined_max += 5;
+
+	// score location
+	auto distance_location = std::numeric_limits<float>::max();
+	const auto& d1 = table.metadata_directions[id_1];
+	const auto& d2 = table.metadata_directions[id_2];
+	auto n_images_with_metadata_locations =
+		(d1.x != 0 || d1.y != 0 || d1.z != 0) +
+		(d2.x != 0 || d2.y != 0 || d2.z != 0);
+	if (n_images_with_metadata_locations == 1) {
+		distance_combined += 1;
+	} else if (n_images_with_metadata_locations == 2) {
+		auto d = earth_distance(d1, d2);
+		distance_location = d;
+		if (d < 10*1000)
+			distance_combined += -5*std::pow(1 - d / (10*1000), 2);
+		else if (d > 100*1000)
+			distance_combined += 5;
+	}
+	distance_combined_min += -5;
+	distance_combined_max += 5;
+
+	// score make and model
+	score_string_ids(table.metadata_make_model_ids[id_1], table.metadata_make_model_ids[id_2], -2, 1, 5, distance_combined);
+	distance_combined_min += -2;
+	distance_combined_max += 5;
+
+	// score camera id
+	score_string_ids(table.metadata_camera_ids[id_1], table.metadata_camera_ids[id_2], -2, 1, 5, distance_combined);
+	distance_combined_min += -2;
+	distance_combined_max += 5;
+
+	// score image id
+	score_string_ids(table.metadata_image_ids[id_1], table.metadata_image_ids[id_2], -10, 2, 10, distance_combined);
+	distance_combined_min += -10;
+	distance_combined_max += 10;
+
+	// score visual similarity, only as far as it could still put the pair
+	// in a category: visual on its own, or combined with the metadata
+	// scored so far and the least dimensions score (0, of at most 10).
+	// beyond distance_visual_max, distance() returns about
+	// distance_visual_max, which then rules out both.
+	const auto visual_fraction = 0.6f;
+	const auto distance_visual_category_max = 0.37f;
+	const auto distance_combined_category_max = 0.37f;
+	const auto distance_metadata_min = (distance_combined - distance_combined_min) /
+		(distance_combined_max + 10 - distance_combined_min);
+	const auto distance_visual_max = std::min(distance_visual_ceiling, 0.001f + std::max(
+		distance_visual_category_max,
+		(distance_combined_category_max - (1-visual_fraction) * distance_metadata_min) / visual_fraction));
+	auto [distance_visual, aspect_ratio_flipped, cropped] = options.quantized
+		? distance(table.quantized_planes[id_1], table.quantized_planes[id_2], distance_visual_max, options)
+		: distance(table.planes[id_1], table.planes[id_2], distance_visual_max, options);
+
+	// score dimensions
+	const auto& size_1 = table.image_sizes[id_1];
+	const auto& size_2 = table.image_sizes[id_2];
+	auto ar1 = static_cast<float>(size_1.w) / size_1.h;
+	auto ar2 = static_cast<float>(size_2.w) / size_2.h;
+	if (aspect_ratio_flipped)
+		ar1 = 1/ar1;
+	if (ar1 < 1) {
+		ar1 = 1/ar1;
+		ar2 = 1/ar2;
+	}
+	if (!cropped)
+		distance_combined += std::min(10.0f*std::sqrt(std::abs(ar1 - ar2)), 10.0f);
+	distance_combined_min += 0;
+	distance_combined_max += 10;
+
+	// normalize distance
+	distance_combined = (distance_combined - distance_combined_min) /
+		(distance_combined_max - distance_combined_min);
+
+	distance_combined = visual_fraction * distance_visual + (1-visual_fraction) * distance_combined;
+
+	// assign image pair to relevant image pair categories
+
+	if (distance_time < std::chrono::duration<float>(time_category_max_distance).count())
+		score.distances[static_cast<int>(Category::time)] = distance_time;
+	if (distance_location < location_category_max_distance)
+		score.distances[static_cast<int>(Category::location)] = distance_location;
+
+	bool aspect_ratios_too_dissimilar = ar1/ar2 > 1.75f || ar2/ar1 > 1.75f;
+	bool aspect_ratios_inverses = std::abs(1/ar1 - ar2) < 0.01f;
+	if (aspect_ratios_too_dissimilar && !aspect_ratios_inverses && !cropped)
+		return score;
+
+	if (distance_visual < distance_visual_category_max)
+		score.distances[static_cast<int>(Category::visual)] = distance_visual;
+	if (distance_combined < distance_combined_category_max)
+		score.distances[static_cast<int>(Category::combined)] = distance_combined;
+
+	return score;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "image_table.h"
+#include "signature.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Image pair categories, in the order of the scoring menu.
+enum class Category {visual, time, location, combined};
+const auto n_categories = 4;
+
+// Pairs are in the time category if their metadata times are less than
+// this apart.
+const auto time_category_max_distance = std::chrono::hours{12};
+
+// Pairs are in the location category if their metadata positions are less
+// than this many metres apart.
+const auto location_category_max_distance = 10*1000.0f;
+
+const auto earth_mean_radius = 6371*1000.0f;
+
+// score() compares the planes of a pair no further than this. A pair
+// visually further apart is in neither the visual nor the combined
+// category, unless the metadata image ids of its images are equal: only
+// their bonus can bring the metadata distance low enough for the combined
+// category to take a pair beyond it.
+const auto distance_visual_ceiling = 0.6f;
+
+Direction get_direction(const Position& position);
+
+// Great circle distances in metres. Directions are compared by the chord
+// between them, which is exact for short distances in single precision.
+float earth_distance(const Direction& d1, const Direction& d2);
+float earth_distance(const Position& p1, const Position& p2);
+
+std::chrono::system_clock::duration time_distance(const ImageInfo& info_1, const ImageInfo& info_2);
+float location_distance(const ImageInfo& info_1, const ImageInfo& info_2);
+
+// Distances of an image pair in each category. A distance is
+// std::numeric_limits<float>::max() if the pair is not in that category.
+struct Score {
+	float distances[n_categories];
+};
+
+// Image indices, index_1 < index_2, and distance of a pair of images.
+struct SignaturePair {
+	std::uint32_t index_1;
+	std::uint32_t index_2;
+	float distance;
+};
+
+// Distance and index_1 of pair as one integer in the same order, to sort
+// by with a single comparison in all but the rarest cases.
+inline std::uint64_t get_sort_key(const SignaturePair& pair) {
+	std::uint32_t bits;
+	std::memcpy(&bits, &pair.distance, sizeof bits);
+	bits ^= bits >> 31 ? 0xffffffff : 0x80000000; // float order as unsigned
+	return static_cast<std::uint64_t>(bits) << 32 | pair.index_1;
+}
+
+// By distance, then by image indices. Images are indexed in path order, so
+// an index is a precomputed path rank and this is the order of paths
+// without comparing any.
+inline bool operator<(const SignaturePair& lhs, const SignaturePair& rhs) {
+	const auto key_lhs = get_sort_key(lhs);
+	const auto key_rhs = get_sort_key(rhs);
+	if (key_lhs != key_rhs)
+		return key_lhs < key_rhs;
+	return lhs.index_2 < rhs.index_2;
+}
+
+// Scores images id_1 and id_2 of table, which must both be ok and must
+// have the planes of options.
+Score score(const ImageTable& table, const std::uint32_t id_1, const std::uint32_t id_2, const CompareOptions& options);
@@ -0,0 +1,725 @@
+#include "signature.h"
+
+#include "summed_area_table.h"
+
+#include "../shared/assert.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+Intensity get_intensity(const IntensityArray& intensities, const int x, const int y, const ImageTransform transform) {
+	const int n_intensity_block_divisions = static_cast<int>(intensities.size());
+
+	auto xt = x;
+	auto yt = y;
+
+	switch (transform) {
+	case ImageTransform::none:
+		break;
+	case ImageTransform::rotate_90:
+		xt = n_intensity_block_divisions - 1 - y;
+		yt = x;
+		break;
+	case ImageTransform::rotate_180:
+		xt = n_intensity_block_divisions - 1 - x;
+		yt = n_intensity_block_divisions - 1 - y;
+		break;
+	case ImageTransform::rotate_270:
+		xt = y;
+		yt = n_intensity_block_divisions - 1 - x;
+		break;
+	case ImageTransform::flip_h:
+		xt = n_intensity_block_divisions - 1 - x;
+		yt = y;
+		break;
+	case ImageTransform::flip_v:
+		xt = x;
+		yt = n_intensity_block_divisions - 1 - y;
+		break;
+	case ImageTransform::flip_nw_se:
+		xt = y;
+		yt = x;
+		break;
+	case ImageTransform::flip_sw_ne:
+		xt = n_intensity_block_divisions - 1 - y;
+		yt = n_intensity_block_divisions - 1 - x;
+		break;
+	default:
+		assert(false);
+	}
+
+	return intensities[yt][xt];
+}
+
+namespace {
+	using BlockIndices = std::array<int, std::tuple_size<IntensityArray>::value * std::tuple_size<IntensityArray>::value>;
+
+	struct TransformTables {
+		// index (y * 8 + x) of the block that get_intensity() reads for each block
+		std::array<BlockIndices, 8> source_blocks;
+		// comparing the first array with transform relative[t1][t2] of the
+		// second is comparing transform t1 of the first with t2 of the second
+		std::array<std::array<ImageTransform, 8>, 8> relative;
+	};
+}
+
+static const TransformTables& get_transform_tables() {
+	static const auto tables = [] {
+		const auto n_intensity_block_divisions = static_cast<int>(std::tuple_size<IntensityArray>::value);
+		const auto n_blocks = n_intensity_block_divisions * n_intensity_block_divisions;
+
+		IntensityArray indices;
+		for (auto y = 0; y < n_intensity_block_divisions; y++)
+			for (auto x = 0; x < n_intensity_block_divisions; x++)
+				indices[y][x].r = static_cast<float>(y * n_intensity_block_divisions + x);
+
+		TransformTables tables;
+		for (auto t = 0; t < 8; t++)
+			for (auto y = 0; y < n_intensity_block_divisions; y++)
+				for (auto x = 0; x < n_intensity_block_divisions; x++)
+					tables.source_blocks[t][y * n_intensity_block_divisions + x] =
+						static_cast<int>(get_intensity(indices, x, y, static_cast<ImageTransform>(t)).r);
+
+		// block i of the first array faces block source_2[inverse_1[i]] of the second
+		for (auto t1 = 0; t1 < 8; t1++) {
+			BlockIndices inverse_1;
+			for (auto i = 0; i < n_blocks; i++)
+				inverse_1[tables.source_blocks[t1][i]] = i;
+
+			for (auto t2 = 0; t2 < 8; t2++) {
+				BlockIndices source;
+				for (auto i = 0; i < n_blocks; i++)
+					source[i] = tables.source_blocks[t2][inverse_1[i]];
+
+				const auto t = std::find(tables.source_blocks.begin(), tables.source_blocks.end(), source);
+				assert(t != tables.source_blocks.end());
+				tables.relative[t1][t2] = static_cast<ImageTransform>(t - tables.source_blocks.begin());
+			}
+		}
+		return tables;
+	}();
+	return tables;
+}
+
+// Quadrant sums of r + g + b, which range from 0 to 48, closer than this
+// make the canonical orientation ambiguous.
+const auto canonical_orientation_margin = 2.0f;
+
+static std::optional<ImageTransform> get_canonical_transform(const IntensityArray& intensities) {
+	const auto n_intensity_block_divisions = static_cast<int>(intensities.size());
+	const auto half = n_intensity_block_divisions / 2;
+
+	float quadrants[2][2] {};
+	for (auto y = 0; y < n_intensity_block_divisions; y++)
+		for (auto x = 0; x < n_intensity_block_divisions; x++)
+			quadrants[y / half][x / half] += intensities[y][x].r + intensities[y][x].g + intensities[y][x].b;
+
+	// source quadrants of the top left and top right quadrants of a transform
+	const auto& tables = get_transform_tables();
+	auto get_quadrant = [&](const int t, const int x) {
+		const auto i = tables.source_blocks[t][x];
+		return &quadrants[i / n_intensity_block_divisions / half][i % n_intensity_block_divisions / half];
+	};
+
+	auto best = 0;
+	for (auto t = 1; t < 8; t++) {
+		const auto tl = get_quadrant(t, 0);
+		const auto tl_best = get_quadrant(best, 0);
+		if (*tl > *tl_best || (tl == tl_best && *get_quadrant(t, n_intensity_block_divisions - 1) > *get_quadrant(best, n_intensity_block_divisions - 1)))
+			best = t;
+	}
+
+	for (auto t = 0; t < 8; t++) {
+		if (t == best)
+			continue;
+		const auto same_top_left = get_quadrant(t, 0) == get_quadrant(best, 0);
+		const auto x = same_top_left ? n_intensity_block_divisions - 1 : 0;
+		if (*get_quadrant(best, x) - *get_quadrant(t, x) < canonical_orientation_margin)
+			return std::nullopt;
+	}
+
+	return static_cast<ImageTransform>(best);
+}
+
+template<int n>
+static CoarsePlanes<n> get_coarse_planes(const IntensityPlanes& planes) {
+	const auto n_intensity_block_divisions = static_cast<int>(std::tuple_size<IntensityPlanes::Plane>::value);
+	const auto cell_size = n_intensity_block_divisions / n;
+
+	CoarsePlanes<n> coarse{};
+	for (auto c = 0; c < 3; c++) {
+		for (auto y = 0; y < n_intensity_block_divisions; y++)
+			for (auto x = 0; x < n_intensity_block_divisions; x++)
+				coarse.rows[c][y / cell_size][x / cell_size] += planes.rows[c][y][x];
+		for (auto y = 0; y < n; y++) {
+			for (auto x = 0; x < n; x++) {
+				coarse.rows[c][y][x] /= cell_size * cell_size;
+				coarse.columns[c][x][y] = coarse.rows[c][y][x];
+			}
+		}
+	}
+	return coarse;
+}
+
+IntensityPlanes get_intensity_planes(const IntensityArray& intensities) {
+	static_assert(std::tuple_size<IntensityArray>::value == std::tuple_size<IntensityPlanes::Plane>::value);
+	const auto n_intensity_block_divisions = static_cast<int>(intensities.size());
+
+	IntensityPlanes planes;
+	for (auto y = 0; y < n_intensity_block_divisions; y++) {
+		for (auto x = 0; x < n_intensity_block_divisions; x++) {
+			const auto& i = intensities[y][x];
+			planes.rows[0][y][x] = planes.columns[0][x][y] = i.r;
+			planes.rows[1][y][x] = planes.columns[1][x][y] = i.g;
+			planes.rows[2][y][x] = planes.columns[2][x][y] = i.b;
+		}
+	}
+	planes.planes_4 = get_coarse_planes<4>(planes);
+	planes.planes_2 = get_coarse_planes<2>(planes);
+	// the means are only ever taken here, of the 2 x 2 cells already summed
+	for (auto c = 0; c < 3; c++) {
+		const auto& cells = planes.planes_2.rows[c];
+		planes.means[c] = (cells[0][0] + cells[0][1] + cells[1][0] + cells[1][1]) / 4;
+	}
+	planes.canonical_transform = get_canonical_transform(intensities);
+	return planes;
+}
+
+QuantizedPlanes quantize(const IntensityPlanes& planes) {
+	auto quantize_plane = [](const IntensityPlanes::Plane& plane) {
+		QuantizedPlanes::Plane quantized;
+		for (std::size_t y = 0; y < plane.size(); y++)
+			for (std::size_t x = 0; x < plane[y].size(); x++)
+				quantized[y * plane[y].size() + x] = static_cast<std::uint8_t>(std::lround(std::clamp(plane[y][x], 0.0f, 1.0f) * 255));
+		return quantized;
+	};
+
+	QuantizedPlanes quantized;
+	for (auto c = 0; c < 3; c++) {
+		quantized.rows[c] = quantize_plane(planes.rows[c]);
+		quantized.columns[c] = quantize_plane(planes.columns[c]);
+	}
+	quantized.canonical_transform = planes.canonical_transform;
+	return quantized;
+}
+
+namespace {
+	// How a transform reads row y of IntensityPlanes: from rows or columns,
+	// from row y or its mirror, with its blocks in order or reversed.
+	struct TransformRows {
+		bool transposed;
+		bool rows_reversed;
+		bool blocks_reversed;
+	};
+}
+
+// indexed by ImageTransform
+const TransformRows transform_rows[] {
+	{false, false, false}, // none: [y][x]
+	{true, true, false},   // rotate_90: [x][7 - y]
+	{false, true, true},   // rotate_180: [7 - y][7 - x]
+	{true, false, true},   // rotate_270: [7 - x][y]
+	{false, false, true},  // flip_h: [y][7 - x]
+	{false, true, false},  // flip_v: [7 - y][x]
+	{true, false, false},  // flip_nw_se: [x][y]
+	{true, true, true},    // flip_sw_ne: [7 - x][7 - y]
+};
+
+// Sum of block distances of a transform, accumulated per block column and
+// added up after each row in the order (0 + 4 + 2 + 6) + (1 + 5 + 3 + 7),
+// or the partial sum of the first row where that exceeds maximum_sum.
+
+static float transform_distance_scalar(
+	const IntensityPlanes& intensities_1,
+	const IntensityPlanes& intensities_2,
+	const TransformRows& transform,
+	const float maximum_sum
+) {
+	const auto n = static_cast<int>(std::tuple_size<IntensityPlanes::Plane>::value);
+	const auto& planes_2 = transform.transposed ? intensities_2.columns : intensities_2.rows;
+
+	float sums[n] {};
+	auto s = 0.0f;
+	for (auto y = 0; y < n; y++) {
+		const auto y2 = transform.rows_reversed ? n - 1 - y : y;
+		for (auto x = 0; x < n; x++) {
+			const auto x2 = transform.blocks_reversed ? n - 1 - x : x;
+			auto d = 0.0f;
+			for (auto c = 0; c < 3; c++)
+				d += std::abs(planes_2[c][y2][x2] - intensities_1.rows[c][y][x]);
+			sums[x] += d;
+		}
+
+		s = ((sums[0] + sums[4]) + (sums[2] + sums[6])) + ((sums[1] + sums[5]) + (sums[3] + sums[7]));
+		if (s > maximum_sum)
+			break;
+	}
+	return s;
+}
+
+#ifdef SIMD_X86
+static float transform_distance_sse2(
+	const IntensityPlanes& intensities_1,
+	const IntensityPlanes& intensities_2,
+	const TransformRows& transform,
+	const float maximum_sum
+) {
+	const auto n = static_cast<int>(std::tuple_size<IntensityPlanes::Plane>::value);
+	const auto& planes_2 = transform.transposed ? intensities_2.columns : intensities_2.rows;
+	const auto sign = _mm_set1_ps(-0.0f);
+
+	auto sums_lo = _mm_setzero_ps();
+	auto sums_hi = _mm_setzero_ps();
+	auto s = 0.0f;
+	for (auto y = 0; y < n; y++) {
+		const auto y2 = transform.rows_reversed ? n - 1 - y : y;
+		auto d_lo = _mm_setzero_ps();
+		auto d_hi = _mm_setzero_ps();
+		for (auto c = 0; c < 3; c++) {
+			auto i2_lo = _mm_loadu_ps(&planes_2[c][y2][0]);
+			auto i2_hi = _mm_loadu_ps(&planes_2[c][y2][4]);
+			if (transform.blocks_reversed) {
+				const auto lo = _mm_shuffle_ps(i2_hi, i2_hi, _MM_SHUFFLE(0, 1, 2, 3));
+				i2_hi = _mm_shuffle_ps(i2_lo, i2_lo, _MM_SHUFFLE(0, 1, 2, 3));
+				i2_lo = lo;
+			}
+			const auto i1_lo = _mm_loadu_ps(&intensities_1.rows[c][y][0]);
+			const auto i1_hi = _mm_loadu_ps(&intensities_1.rows[c][y][4]);
+			d_lo = _mm_add_ps(d_lo, _mm_andnot_ps(sign, _mm_sub_ps(i2_lo, i1_lo)));
+			d_hi = _mm_add_ps(d_hi, _mm_andnot_ps(sign, _mm_sub_ps(i2_hi, i1_hi)));
+		}
+		sums_lo = _mm_add_ps(sums_lo, d_lo);
+		sums_hi = _mm_add_ps(sums_hi, d_hi);
+
+		auto t = _mm_add_ps(sums_lo, sums_hi);
+		t = _mm_add_ps(t, _mm_movehl_ps(t, t));
+		t = _mm_add_ss(t, _mm_shuffle_ps(t, t, _MM_SHUFFLE(1, 1, 1, 1)));
+		s = _mm_cvtss_f32(t);
+		if (s > maximum_sum)
+			break;
+	}
+	return s;
+}
+#endif
+
+static float transform_distance(
+	const IntensityPlanes& intensities_1,
+	const IntensityPlanes& intensities_2,
+	const ImageTransform transform,
+	const float maximum_sum,
+	const SimdLevel level
+) {
+	const auto& t = transform_rows[static_cast<int>(transform)];
+	#ifdef SIMD_X86
+		if (level != SimdLevel::scalar)
+			return transform_distance_sse2(intensities_1, intensities_2, t, maximum_sum);
+	#endif
+	return transform_distance_scalar(intensities_1, intensities_2, t, maximum_sum);
+}
+
+// Relative margin by which a lower bound from a coarser level must exceed
+// a sum of block distances to rule it out, as the two are rounded
+// differently.
+const auto coarse_rejection_margin = 1.0001f;
+
+// Lower bound of transform_distance() from the cells of a coarser level:
+// their distance times the blocks per cell.
+template<int n>
+static float coarse_transform_distance(
+	const CoarsePlanes<n>& planes_1,
+	const CoarsePlanes<n>& planes_2,
+	const TransformRows& transform
+) {
+	const auto n_intensity_block_divisions = static_cast<int>(std::tuple_size<IntensityPlanes::Plane>::value);
+	const auto& rows_2 = transform.transposed ? planes_2.columns : planes_2.rows;
+
+	auto s = 0.0f;
+	for (auto c = 0; c < 3; c++) {
+		for (auto y = 0; y < n; y++) {
+			const auto y2 = transform.rows_reversed ? n - 1 - y : y;
+			for (auto x = 0; x < n; x++) {
+				const auto x2 = transform.blocks_reversed ? n - 1 - x : x;
+				s += std::abs(rows_2[c][y2][x2] - planes_1.rows[c][y][x]);
+			}
+		}
+	}
+	return s * (n_intensity_block_divisions / n) * (n_intensity_block_divisions / n);
+}
+
+// Whether all transforms are further than maximum_sum, going by the means.
+static bool is_rejected(
+	const IntensityPlanes& intensities_1,
+	const IntensityPlanes& intensities_2,
+	const float maximum_sum
+) {
+	const auto n_intensity_block_divisions = static_cast<int>(std::tuple_size<IntensityPlanes::Plane>::value);
+	auto s = 0.0f;
+	for (auto c = 0; c < 3; c++)
+		s += std::abs(intensities_2.means[c] - intensities_1.means[c]);
+	return s * n_intensity_block_divisions * n_intensity_block_divisions > maximum_sum * coarse_rejection_margin;
+}
+
+// Whether a transform is further than maximum_sum, going by the 2 x 2 and
+// then the 4 x 4 cells.
+static bool is_rejected(
+	const IntensityPlanes& intensities_1,
+	const IntensityPlanes& intensities_2,
+	const ImageTransform transform,
+	const float maximum_sum
+) {
+	const auto& t = transform_rows[static_cast<int>(transform)];
+	return
+		coarse_transform_distance(intensities_1.planes_2, intensities_2.planes_2, t) > maximum_sum * coarse_rejection_margin ||
+		coarse_transform_distance(intensities_1.planes_4, intensities_2.planes_4, t) > maximum_sum * coarse_rejection_margin;
+}
+
+// Quantized counterparts of the transform_distance_*() functions above,
+// summing integer absolute differences exactly, so the early exit may as
+// well be per half of the rows. The sums are returned scaled back to
+// intensities.
+
+static float transform_distance_scalar(
+	const QuantizedPlanes& intensities_1,
+	const QuantizedPlanes& intensities_2,
+	const TransformRows& transform,
+	const float maximum_sum
+) {
+	const auto n = static_cast<int>(std::tuple_size<IntensityArray>::value);
+	const auto& planes_2 = transform.transposed ? intensities_2.columns : intensities_2.rows;
+
+	std::uint32_t s = 0;
+	for (auto y = 0; y < n; y++) {
+		const auto y2 = transform.rows_reversed ? n - 1 - y : y;
+		for (auto c = 0; c < 3; c++) {
+			for (auto x = 0; x < n; x++) {
+				const auto x2 = transform.blocks_reversed ? n - 1 - x : x;
+				s += std::abs(planes_2[c][y2 * n + x2] - intensities_1.rows[c][y * n + x]);
+			}
+		}
+		if (s > maximum_sum * 255)
+			break;
+	}
+	return s / 255.0f;
+}
+
+#ifdef SIMD_X86
+TARGET_AVX2 static float transform_distance_avx2(
+	const QuantizedPlanes& intensities_1,
+	const QuantizedPlanes& intensities_2,
+	const TransformRows& transform,
+	const float maximum_sum
+) {
+	const auto& planes_2 = transform.transposed ? intensities_2.columns : intensities_2.rows;
+	const auto reverse_blocks = _mm256_setr_epi8(
+		7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+		7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+
+	// four rows of a plane per vector, one row per sum of _mm256_sad_epu8()
+	auto sums = _mm256_setzero_si256();
+	std::uint32_t s = 0;
+	for (auto half = 0; half < 2; half++) {
+		const auto half_2 = transform.rows_reversed ? 1 - half : half;
+		for (auto c = 0; c < 3; c++) {
+			auto i2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&planes_2[c][half_2 * 32]));
+			if (transform.rows_reversed)
+				i2 = _mm256_permute4x64_epi64(i2, _MM_SHUFFLE(0, 1, 2, 3));
+			if (transform.blocks_reversed)
+				i2 = _mm256_shuffle_epi8(i2, reverse_blocks);
+			const auto i1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&intensities_1.rows[c][half * 32]));
+			sums = _mm256_add_epi64(sums, _mm256_sad_epu8(i1, i2));
+		}
+
+		const auto t = _mm_add_epi64(_mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1));
+		s = static_cast<std::uint32_t>(_mm_cvtsi128_si32(_mm_add_epi64(t, _mm_unpackhi_epi64(t, t))));
+		if (s > maximum_sum * 255)
+			break;
+	}
+	return s / 255.0f;
+}
+#endif
+
+static float transform_distance(
+	const QuantizedPlanes& intensities_1,
+	const QuantizedPlanes& intensities_2,
+	const ImageTransform transform,
+	const float maximum_sum,
+	const SimdLevel level
+) {
+	const auto& t = transform_rows[static_cast<int>(transform)];
+	#ifdef SIMD_X86
+		if (level == SimdLevel::avx2)
+			return transform_distance_avx2(intensities_1, intensities_2, t, maximum_sum);
+	#endif
+	return transform_distance_scalar(intensities_1, intensities_2, t, maximum_sum);
+}
+
+// Quantized planes have no coarser levels: a whole transform takes hardly
+// longer to compare than a level would.
+static bool is_rejected(const QuantizedPlanes&, const QuantizedPlanes&, const float) {
+	return false;
+}
+
+static bool is_rejected(const QuantizedPlanes&, const QuantizedPlanes&, const ImageTransform, const float) {
+	return false;
+}
+
+template<typename Planes>
+static std::pair<float, bool> calculate_distance_all_transforms(
+	const Planes& intensities_1,
+	const Planes& intensities_2,
+	const float maximum_distance,
+	const SimdLevel level
+) {
+	assert(level <= get_simd_level());
+
+	bool aspect_ratio_flipped = false;
+
+	const auto n_intensity_block_divisions = static_cast<int>(std::tuple_size<IntensityArray>::value);
+	auto sum = maximum_distance * n_intensity_block_divisions * n_intensity_block_divisions;
+	if (is_rejected(intensities_1, intensities_2, sum))
+		return {maximum_distance, false};
+	for (auto t = 0; t < 8; t++) {
+		if (is_rejected(intensities_1, intensities_2, static_cast<ImageTransform>(t), sum))
+			continue;
+		auto s = transform_distance(intensities_1, intensities_2, static_cast<ImageTransform>(t), sum, level);
+		if (s < sum) {
+			sum = s;
+			aspect_ratio_flipped = transform_rows[t].transposed;
+		}
+	}
+	assert(sum == sum);
+	return {sum / n_intensity_block_divisions / n_intensity_block_divisions, aspect_ratio_flipped};
+}
+
+std::pair<float, bool> calculate_distance(
+	const IntensityPlanes& intensities_1,
+	const IntensityPlanes& intensities_2,
+	const float maximum_distance,
+	const SimdLevel level
+) {
+	return calculate_distance_all_transforms(intensities_1, intensities_2, maximum_distance, level);
+}
+
+std::pair<float, bool> calculate_distance(
+	const QuantizedPlanes& intensities_1,
+	const QuantizedPlanes& intensities_2,
+	const float maximum_distance,
+	const SimdLevel level
+) {
+	return calculate_distance_all_transforms(intensities_1, intensities_2, maximum_distance, level);
+}
+
+// As calculate_distance(), but with both arrays in their canonical
+// orientations only, if they have them.
+template<typename Planes>
+static std::pair<float, bool> calculate_distance(
+	const Planes& intensities_1,
+	const Planes& intensities_2,
+	const float maximum_distance,
+	const CompareOptions& options
+) {
+	if (!options.canonical_orientation || !intensities_1.canonical_transform || !intensities_2.canonical_transform)
+		return calculate_distance(intensities_1, intensities_2, maximum_distance);
+
+	const auto t = get_transform_tables().relative
+		[static_cast<int>(*intensities_1.canonical_transform)]
+		[static_cast<int>(*intensities_2.canonical_transform)];
+
+	const auto n_intensity_block_divisions = static_cast<int>(std::tuple_size<IntensityArray>::value);
+	const auto sum = maximum_distance * n_intensity_block_divisions * n_intensity_block_divisions;
+	if (is_rejected(intensities_1, intensities_2, sum) || is_rejected(intensities_1, intensities_2, t, sum))
+		return {maximum_distance, false};
+	const auto s = transform_distance(intensities_1, intensities_2, t, sum, get_simd_level());
+	if (s < sum)
+		return {s / n_intensity_block_divisions / n_intensity_block_divisions, transform_rows[static_cast<int>(t)].transposed};
+	else
+		return {maximum_distance, false};
+}
+
+template<typename Planes>
+static std::tuple<float, bool, bool> distance_planes(
+	const ImagePlanes<Planes>& planes_1,
+	const ImagePlanes<Planes>& planes_2,
+	const float maximum_distance,
+	const CompareOptions& options
+) {
+	bool cropped = false;
+
+	auto [distance, aspect_ratio_flipped] = calculate_distance(planes_1[0], planes_2[0], maximum_distance, options);
+
+	std::pair<const Planes&, const Planes&> pairs[] {
+		{planes_1[1], planes_2[1]},
+		{planes_1[1], planes_2[2]},
+		{planes_1[2], planes_2[2]},
+	};
+	for (const auto& p : pairs) {
+		auto [d, arf] = calculate_distance(p.first, p.second, maximum_distance, options);
+		if (d < distance) {
+			distance = d;
+			aspect_ratio_flipped = arf;
+			cropped = true;
+		}
+	}
+
+	return {distance, aspect_ratio_flipped, cropped};
+}
+
+std::tuple<float, bool, bool> distance(
+	const ImagePlanes<IntensityPlanes>& planes_1,
+	const ImagePlanes<IntensityPlanes>& planes_2,
+	const float maximum_distance,
+	const CompareOptions& options
+) {
+	return distance_planes(planes_1, planes_2, maximum_distance, options);
+}
+
+std::tuple<float, bool, bool> distance(
+	const ImagePlanes<QuantizedPlanes>& planes_1,
+	const ImagePlanes<QuantizedPlanes>& planes_2,
+	const float maximum_distance,
+	const CompareOptions& options
+) {
+	return distance_planes(planes_1, planes_2, maximum_distance, options);
+}
+
+std::tuple<float, bool, bool> distance(
+	const Signature& signature_1,
+	const Signature& signature_2,
+	const float maximum_distance,
+	const CompareOptions& options
+) {
+	if (signature_1.status != Signature::Status::ok || signature_2.status != Signature::Status::ok)
+		return {std::numeric_limits<float>::max(), false, false};
+
+	ImagePlanes<IntensityPlanes> planes_1;
+	ImagePlanes<IntensityPlanes> planes_2;
+	const IntensityArray* const arrays_1[] {&signature_1.intensities, &signature_1.intensities_cropped_1, &signature_1.intensities_cropped_2};
+	const IntensityArray* const arrays_2[] {&signature_2.intensities, &signature_2.intensities_cropped_1, &signature_2.intensities_cropped_2};
+	for (auto i = 0; i < 3; i++) {
+		planes_1[i] = get_intensity_planes(*arrays_1[i]);
+		planes_2[i] = get_intensity_planes(*arrays_2[i]);
+	}
+	if (!options.quantized)
+		return distance(planes_1, planes_2, maximum_distance, options);
+
+	ImagePlanes<QuantizedPlanes> quantized_planes_1;
+	ImagePlanes<QuantizedPlanes> quantized_planes_2;
+	for (auto i = 0; i < 3; i++) {
+		quantized_planes_1[i] = quantize(planes_1[i]);
+		quantized_planes_2[i] = quantize(planes_2[i]);
+	}
+	return distance(quantized_planes_1, quantized_planes_2, maximum_distance, options);
+}
+
+// Corner of block (bx, by) of the n_intensity_block_divisions^2 blocks
+// that rect is divided into.
+static std::pair<std::uint32_t, std::uint32_t> get_block_corner(const PixelRect& rect, const std::uint32_t bx, const std::uint32_t by) {
+	const auto n_intensity_block_divisions = static_cast<std::uint32_t>(std::tuple_size<IntensityArray>::value);
+	return {
+		rect.left + (rect.right - rect.left) * bx / n_intensity_block_divisions,
+		rect.top + (rect.bottom - rect.top) * by / n_intensity_block_divisions};
+}
+
+static IntensityArray calculate_intensities(const SummedAreaTable& sat, const PixelRect& rect) {
+	IntensityArray intensities;
+	const auto n_intensity_block_divisions = static_cast<int>(intensities.size());
+
+	bool rgb_content = false;
+	bool a_content = false;
+	float alpha[std::tuple_size<IntensityArray>::value][std::tuple_size<IntensityArray>::value];
+
+	for (auto by = 0; by < n_intensity_block_divisions; by++) {
+		for (auto bx = 0; bx < n_intensity_block_divisions; bx++) {
+			const auto [offset_x, offset_y] = get_block_corner(rect, bx + 0, by + 0);
+			const auto [offset_x_next, offset_y_next] = get_block_corner(rect, bx + 1, by + 1);
+
+			const auto sums = sat.get_sums({offset_x, offset_y, offset_x_next, offset_y_next});
+			const auto b = sums[0];
+			const auto g = sums[1];
+			const auto r = sums[2];
+			const auto a = sums[3];
+
+			intensities[by][bx].r = static_cast<float>(r);
+			intensities[by][bx].g = static_cast<float>(g);
+			intensities[by][bx].b = static_cast<float>(b);
+			alpha[by][bx] = static_cast<float>(a);
+
+			rgb_content |= r != 0 || g != 0 || b != 0;
+			a_content |= a != 0;
+		}
+	}
+	// if there is alpha but no RGB content, replace RGB content with alpha content
+	// (GUID_WICPixelFormat32bppPBGRA mode seem to zero RGB content if it can
+	// replace it with alpha content alone.)
+	if (a_content && !rgb_content) {
+		for (auto y = 0; y < n_intensity_block_divisions; y++) {
+			for (auto x = 0; x < n_intensity_block_divisions; x++) {
+				intensities[y][x].r = alpha[y][x];
+				intensities[y][x].g = alpha[y][x];
+				intensities[y][x].b = alpha[y][x];
+			}
+		}
+	}
+
+	// normalize
+
+	auto intensity_min = std::numeric_limits<float>::max();
+	auto intensity_max = 0.0f;
+	for (auto y = 0; y < n_intensity_block_divisions; y++) {
+		for (auto x = 0; x < n_intensity_block_divisions; x++) {
+			intensity_min = std::min(intensity_min, intensities[y][x].r);
+			intensity_min = std::min(intensity_min, intensities[y][x].g);
+			intensity_min = std::min(intensity_min, intensities[y][x].b);
+			intensity_max = std::max(intensity_max, intensities[y][x].r);
+			intensity_max = std::max(intensity_max, intensities[y][x].g);
+			intensity_max = std::max(intensity_max, intensities[y][x].b);
+		}
+	}
+
+	if (intensity_max - intensity_min != 0) {
+		for (auto y = 0; y < n_intensity_block_divisions; y++) {
+			for (auto x = 0; x < n_intensity_block_divisions; x++) {
+				intensities[y][x].r = (intensities[y][x].r - intensity_min) / (intensity_max - intensity_min);
+				intensities[y][x].g = (intensities[y][x].g - intensity_min) / (intensity_max - intensity_min);
+				intensities[y][x].b = (intensities[y][x].b - intensity_min) / (intensity_max - intensity_min);
+			}
+		}
+	}
+
+	return intensities;
+}
+
+void calculate_intensities(
+	Signature& signature,
+	const std::uint8_t* const pixel_buffer,
+	const PixelSize& size,
+	const int line_stride
+) {
+	assert(size.w > 0 && size.h > 0);
+
+	signature.image_size = size;
+
+	auto square_size = std::min(size.w, size.h);
+	const PixelRect rects[] {
+		{0, 0, size.w, size.h},
+		{0, 0, square_size, square_size},
+		{size.w - square_size, size.h - square_size, size.w, size.h},
+	};
+
+	// one summed-area table with all block edges of all rects
+	std::vector<std::uint32_t> column_boundaries;
+	std::vector<std::uint32_t> row_boundaries;
+	for (const auto& rect : rects) {
+		for (std::uint32_t i = 0; i <= std::tuple_size<IntensityArray>::value; i++) {
+			const auto [x, y] = get_block_corner(rect, i, i);
+			column_boundaries.push_back(x);
+			row_boundaries.push_back(y);
+		}
+	}
+	SummedAreaTable sat{pixel_buffer, size, line_stride, column_boundaries, row_boundaries};
+
+	signature.intensities = calculate_intensities(sat, rects[0]);
+	signature.intensities_cropped_1 = calculate_intensities(sat, rects[1]);
+	signature.intensities_cropped_2 = calculate_intensities(sat, rects[2]);
+}
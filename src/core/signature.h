@@ -0,0 +1,198 @@
+#pragma once
+
+#include "hash.h"
+#include "simd.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+struct Intensity {
+	float r;
+	float g;
+	float b;
+};
+using IntensityArray = std::array<std::array<Intensity, 8>, 8>;
+
+enum class ImageTransform {
+	none, rotate_90, rotate_180, rotate_270,
+	flip_h, flip_v, flip_nw_se, flip_sw_ne,
+};
+
+// Averages of the blocks of IntensityPlanes in n x n cells, laid out the
+// same way (r, g and b of the cells and of their transpose), so that every
+// ImageTransform reads them as it reads the blocks.
+template<int n>
+struct CoarsePlanes {
+	using Plane = std::array<std::array<float, n>, n>;
+	std::array<Plane, 3> rows;
+	std::array<Plane, 3> columns;
+};
+
+// IntensityArray rearranged for calculate_distance(): planes of r, g and b
+// of the array and of its transpose. Every ImageTransform of the array can
+// then be read a whole row at a time, as a row of either layout taken in
+// order or in reverse with or without its blocks reversed.
+struct IntensityPlanes {
+	using Plane = std::array<std::array<float, 8>, 8>;
+	std::array<Plane, 3> rows;
+	std::array<Plane, 3> columns;
+
+	// Coarser levels of the planes, of 4 x 4, 2 x 2 and 1 x 1 cells. The
+	// distance between cell averages, times the blocks per cell, is a lower
+	// bound of the distance between the blocks, so calculate_distance()
+	// rejects a transform at the first level already beyond the best so far.
+	CoarsePlanes<4> planes_4;
+	CoarsePlanes<2> planes_2;
+	std::array<float, 3> means; // the one copy of the means, read by the rejection
+
+	// Transform that puts the brightest quadrant top left and the brighter
+	// of its neighbours top right, or none if that is too close to call.
+	std::optional<ImageTransform> canonical_transform;
+};
+
+// IntensityPlanes quantized to 8 bits (round(intensity * 255)), a quarter
+// of the size and compared with integer sums of absolute differences.
+struct QuantizedPlanes {
+	using Plane = std::array<std::uint8_t, 8 * 8>; // [y * 8 + x]
+	std::array<Plane, 3> rows;
+	std::array<Plane, 3> columns;
+
+	std::optional<ImageTransform> canonical_transform;
+};
+
+// Planes of the whole image and of its two square crops.
+template<typename Planes>
+using ImagePlanes = std::array<Planes, 3>;
+
+struct PixelSize {
+	std::uint32_t w;
+	std::uint32_t h;
+};
+
+struct PixelRect {
+	std::uint32_t left;
+	std::uint32_t top;
+	std::uint32_t right;
+	std::uint32_t bottom;
+};
+
+// Longitude (x) and latitude (y) in degrees. {0, 0} means no position.
+struct Position {
+	float x;
+	float y;
+};
+
+// Unit vector from the centre of the earth towards a position, so that
+// distances need no trigonometry. {0, 0, 0} means no position.
+struct Direction {
+	float x;
+	float y;
+	float z;
+};
+
+// What is known of an image besides its intensities: whether it could be
+// decoded, its size, the metadata used for scoring and its hashes. All
+// that is kept of an image once it is in an ImageTable.
+struct ImageInfo {
+	enum class Status {ok, open_failed, decode_failed};
+	Status status = Status::ok;
+
+	PixelSize image_size{0, 0};
+
+	std::vector<std::chrono::system_clock::time_point> metadata_times; // sorted, see normalize_metadata_times()
+	std::wstring metadata_make_model;
+	std::wstring metadata_camera_id;
+	std::wstring metadata_image_id;
+	Position metadata_position{0, 0};
+
+	Hash file_hash;
+	Hash pixel_hash; // of the premultiplied 32 bpp BGRA pixels
+};
+
+// Everything the similarity engine knows about an image: its ImageInfo and
+// the visual signature, intensities of the whole image and of its two
+// square crops. The planes compared are computed from the intensities by
+// the ImageTable, only those of its CompareOptions. Windows and image
+// decoders are deliberately absent so that the engine can run headless.
+struct Signature : ImageInfo {
+	IntensityArray intensities;
+	IntensityArray intensities_cropped_1;
+	IntensityArray intensities_cropped_2;
+};
+
+Intensity get_intensity(const IntensityArray& intensities, const int x, const int y, const ImageTransform transform);
+
+IntensityPlanes get_intensity_planes(const IntensityArray& intensities);
+QuantizedPlanes quantize(const IntensityPlanes& planes);
+
+// Sets the image size and all intensity arrays (block averages of the
+// whole image and of its two square crops, normalized to [0, 1]) of
+// signature from a 32 bpp BGRA (premultiplied) pixel buffer, in a single
+// pass over the pixels.
+void calculate_intensities(
+	Signature& signature,
+	const std::uint8_t* const pixel_buffer,
+	const PixelSize& size,
+	const int line_stride);
+
+// Smallest mean block distance over all eight transforms of intensities_2,
+// and whether it had its aspect ratio flipped. Transforms stop being
+// evaluated once they exceed the best so far, which starts at
+// maximum_distance, and are not evaluated at all if a coarser level of the
+// planes already does. All levels give identical results, but the block
+// distances are added per block column and then across, not one block
+// after the other, so they differ from that sum by rounding (within 1e-5).
+std::pair<float, bool> calculate_distance(
+	const IntensityPlanes& intensities_1,
+	const IntensityPlanes& intensities_2,
+	const float maximum_distance,
+	const SimdLevel level = get_simd_level());
+
+// As above, from quantized planes. The result differs from that of the
+// planes they were quantized from by at most 3 / 255 (0.0118): each of the
+// three channel differences of a block is off by at most 1 / 255.
+std::pair<float, bool> calculate_distance(
+	const QuantizedPlanes& intensities_1,
+	const QuantizedPlanes& intensities_2,
+	const float maximum_distance,
+	const SimdLevel level = get_simd_level());
+
+struct CompareOptions {
+	// Compare intensity arrays in their canonical orientations only, rather
+	// than in all eight, unless either orientation is ambiguous. Much
+	// faster, but a pair whose canonical orientations disagree (after
+	// editing, say) can be missed or scored higher.
+	bool canonical_orientation = false;
+
+	// Compare quantized planes, within 0.0118 of the exact distance (see
+	// calculate_distance()), so pairs that close to a threshold can change
+	// category.
+	bool quantized = false;
+};
+
+// Visual distance, whether the best match had its aspect ratio flipped
+// and whether the best match was between crops. Computes the planes of
+// both signatures, so an ImageTable is the way to compare many.
+std::tuple<float, bool, bool> distance(
+	const Signature& signature_1,
+	const Signature& signature_2,
+	const float maximum_distance,
+	const CompareOptions& options = {});
+
+// As above, of images with ok signatures, ignoring options.quantized.
+std::tuple<float, bool, bool> distance(
+	const ImagePlanes<IntensityPlanes>& planes_1,
+	const ImagePlanes<IntensityPlanes>& planes_2,
+	const float maximum_distance,
+	const CompareOptions& options = {});
+std::tuple<float, bool, bool> distance(
+	const ImagePlanes<QuantizedPlanes>& planes_1,
+	const ImagePlanes<QuantizedPlanes>& planes_2,
+	const float maximum_distance,
+	const CompareOptions& options = {});
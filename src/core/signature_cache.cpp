@@ -0,0 +1,621 @@
+#include "signature_cache.h"
+
+#include "../shared/assert.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+
+namespace {
+	// Bytes of a heap.
+	struct HeapRef {
+		std::uint64_t offset;
+		std::uint64_t size;
+	};
+
+	struct Header {
+		char magic[8];
+		std::uint32_t version;
+		std::uint32_t byte_order;
+		std::uint64_t n_records;
+		std::uint64_t index_offset; // n_records IndexEntry
+		std::uint64_t n_contents;
+		std::uint64_t contents_offset; // n_contents ContentEntry
+		std::uint64_t records_offset; // n_records Record
+		std::uint64_t heap_offset; // to the end of the file
+		std::uint64_t file_size;
+		Hash hash; // of the above
+	};
+
+	struct IndexEntry {
+		HeapRef path; // UTF-8
+	};
+
+	// Of each record with a partial hash.
+	struct ContentEntry {
+		std::uint64_t file_size;
+		Hash partial_hash;
+		std::uint64_t record;
+	};
+
+	// The record of the index entry with the same number, read and hashed
+	// in place. The hash is of the fields before the heap refs, the path and
+	// the heap data, so that the record can move to another heap and be
+	// used again as it is.
+	struct Record {
+		FileStamp stamp;
+		Hash file_hash;
+		Hash pixel_hash;
+		Hash partial_hash; // 0 if not known
+		std::array<IntensityArray, 3> intensities; // if ok, whole image and crops
+		PixelSize image_size;
+		Position metadata_position;
+		std::uint32_t status;
+		std::uint32_t reserved;
+		HeapRef metadata_times; // 64-bit microseconds since the epoch
+		HeapRef metadata_make_model; // 32-bit code units
+		HeapRef metadata_camera_id;
+		HeapRef metadata_image_id;
+		std::uint64_t last_used; // days since the epoch
+		Hash hash;
+	};
+
+	// without padding, which would be hashed
+	static_assert(sizeof(Header) == 8 + 4 + 4 + 8 * 7 + 16);
+	static_assert(sizeof(Record) == 16 * 4 + sizeof(std::array<IntensityArray, 3>) + 8 + 8 + 4 + 4 + 16 * 4 + 8 + 16);
+	static_assert(std::is_trivially_copyable_v<Record>);
+}
+
+// Of the data of each heap ref, so that it can be read in place.
+static const std::size_t heap_alignment = 8;
+
+static const char cache_magic[8] = {'p', 'i', 'x', 'i', 'p', 'l', 'e', 'c'};
+static const std::uint32_t cache_byte_order = 0x01020304;
+
+static std::string get_key(const std::filesystem::path& path) {
+	const auto s = path.u8string();
+	return {s.begin(), s.end()};
+}
+
+static bool is_in_heap(const HeapRef& ref, const std::size_t heap_size) {
+	return ref.offset <= heap_size && ref.size <= heap_size - ref.offset;
+}
+
+static std::uint64_t get_aligned(const std::uint64_t size) {
+	return (size + heap_alignment - 1) / heap_alignment * heap_alignment;
+}
+
+static std::string_view get_path(const IndexEntry& entry, const std::uint8_t* const heap, const std::size_t heap_size) {
+	if (!is_in_heap(entry.path, heap_size))
+		return {};
+	return {reinterpret_cast<const char*>(heap + entry.path.offset), static_cast<std::size_t>(entry.path.size)};
+}
+
+static std::array<HeapRef*, 4> get_heap_refs(Record& record) {
+	return {&record.metadata_times, &record.metadata_make_model, &record.metadata_camera_id, &record.metadata_image_id};
+}
+
+static std::array<const HeapRef*, 4> get_heap_refs(const Record& record) {
+	return {&record.metadata_times, &record.metadata_make_model, &record.metadata_camera_id, &record.metadata_image_id};
+}
+
+// Hash of record with its path and the heap data it refers to, or none if
+// that is not in the heap: of the hashes of each, so that all are hashed
+// where they are.
+static std::optional<Hash> get_record_hash(
+	const Record& record,
+	const std::string_view path,
+	const std::uint8_t* const heap,
+	const std::size_t heap_size
+) {
+	std::array<Hash, 2 + 4> hashes;
+	hashes[0] = Hash(reinterpret_cast<const std::uint8_t*>(&record), offsetof(Record, metadata_times));
+	hashes[1] = Hash(reinterpret_cast<const std::uint8_t*>(path.data()), path.size());
+	const auto refs = get_heap_refs(record);
+	for (std::size_t i = 0; i < refs.size(); i++) {
+		if (!is_in_heap(*refs[i], heap_size))
+			return std::nullopt;
+		if (refs[i]->size > 0) // else Hash{}, which no data hashes to
+			hashes[2 + i] = Hash(heap + refs[i]->offset, static_cast<std::size_t>(refs[i]->size));
+	}
+	return Hash(reinterpret_cast<const std::uint8_t*>(hashes.data()), sizeof hashes);
+}
+
+template<typename T>
+static HeapRef append(std::vector<std::uint8_t>& heap, const std::vector<T>& values) {
+	static_assert(std::is_trivially_copyable_v<T>);
+	const HeapRef ref{get_aligned(heap.size()), values.size() * sizeof(T)};
+	heap.resize(static_cast<std::size_t>(ref.offset + ref.size));
+	if (!values.empty())
+		std::memcpy(heap.data() + ref.offset, values.data(), ref.size);
+	return ref;
+}
+
+// as 32-bit code units, whatever the size of wchar_t
+static HeapRef append(std::vector<std::uint8_t>& heap, const std::wstring& s) {
+	return append(heap, std::vector<std::uint32_t>(s.begin(), s.end()));
+}
+
+static std::uint32_t get_day(const std::chrono::system_clock::time_point time) {
+	return static_cast<std::uint32_t>(std::chrono::duration_cast<std::chrono::hours>(time.time_since_epoch()).count() / 24);
+}
+
+static void write_record(
+	const std::string_view path,
+	const FileStamp& stamp,
+	const Hash& partial_hash,
+	const Signature& signature,
+	std::vector<std::uint8_t>& record_data,
+	std::vector<std::uint8_t>& heap
+) {
+	Record record{};
+	record.stamp = stamp;
+	record.file_hash = signature.file_hash;
+	record.pixel_hash = signature.pixel_hash;
+	record.partial_hash = partial_hash;
+
+	// in microseconds, the finest period that spans years 0 to 9999 in 64 bits
+	std::vector<std::int64_t> times;
+	for (const auto& t : signature.metadata_times)
+		times.push_back(std::chrono::duration_cast<std::chrono::microseconds>(t.time_since_epoch()).count());
+	record.metadata_times = append(heap, times);
+	record.metadata_make_model = append(heap, signature.metadata_make_model);
+	record.metadata_camera_id = append(heap, signature.metadata_camera_id);
+	record.metadata_image_id = append(heap, signature.metadata_image_id);
+
+	if (signature.status == Signature::Status::ok)
+		record.intensities = {signature.intensities, signature.intensities_cropped_1, signature.intensities_cropped_2};
+	record.image_size = signature.image_size;
+	record.metadata_position = signature.metadata_position;
+	record.status = static_cast<std::uint32_t>(signature.status);
+	record.last_used = get_day(std::chrono::system_clock::now());
+
+	record.hash = *get_record_hash(record, path, heap.data(), heap.size());
+	const auto r = reinterpret_cast<const std::uint8_t*>(&record);
+	record_data.assign(r, r + sizeof record);
+}
+
+// Signature of record, of path, as it is in record and heap, or none if
+// the record is damaged.
+static std::optional<ImageTable::SignatureView> get_view(
+	const Record& record,
+	const std::string_view path,
+	const std::uint8_t* const heap,
+	const std::size_t heap_size
+) {
+	const auto hash = get_record_hash(record, path, heap, heap_size);
+	if (!hash || !(*hash == record.hash) || record.status > static_cast<std::uint32_t>(Signature::Status::decode_failed))
+		return std::nullopt;
+	const auto refs = get_heap_refs(record);
+	if (std::any_of(refs.begin(), refs.end(), [](const HeapRef* ref) { return ref->offset % heap_alignment != 0; }))
+		return std::nullopt;
+
+	auto get_string = [&](const HeapRef& ref) {
+		return std::u32string_view{reinterpret_cast<const char32_t*>(heap + ref.offset), static_cast<std::size_t>(ref.size / sizeof(char32_t))};
+	};
+	return ImageTable::SignatureView{
+		static_cast<Signature::Status>(record.status),
+		record.image_size,
+		{&record.intensities[0], &record.intensities[1], &record.intensities[2]},
+		reinterpret_cast<const std::int64_t*>(heap + record.metadata_times.offset),
+		static_cast<std::size_t>(record.metadata_times.size / sizeof(std::int64_t)),
+		get_string(record.metadata_make_model),
+		get_string(record.metadata_camera_id),
+		get_string(record.metadata_image_id),
+		record.metadata_position,
+	};
+}
+
+// as 32-bit code units, whatever the size of wchar_t
+static std::wstring get_wstring(const std::u32string_view s) {
+	std::wstring w;
+	for (auto u : s)
+		w.push_back(static_cast<wchar_t>(u));
+	return w;
+}
+
+// Signature of record, seen as view.
+static std::shared_ptr<Signature> read_signature(const Record& record, const ImageTable::SignatureView& view) {
+	auto signature = std::make_shared<Signature>();
+	signature->status = view.status;
+	signature->image_size = view.image_size;
+	if (signature->status == Signature::Status::ok) {
+		signature->intensities = *view.intensities[0];
+		signature->intensities_cropped_1 = *view.intensities[1];
+		signature->intensities_cropped_2 = *view.intensities[2];
+	}
+
+	for (std::size_t i = 0; i < view.n_metadata_times; i++)
+		signature->metadata_times.push_back(std::chrono::system_clock::time_point{
+			std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::microseconds{view.metadata_times[i]})});
+	signature->metadata_make_model = get_wstring(view.metadata_make_model);
+	signature->metadata_camera_id = get_wstring(view.metadata_camera_id);
+	signature->metadata_image_id = get_wstring(view.metadata_image_id);
+	signature->metadata_position = view.metadata_position;
+	signature->file_hash = record.file_hash;
+	signature->pixel_hash = record.pixel_hash;
+
+	return signature;
+}
+
+static Hash get_header_hash(const Header& header) {
+	return Hash(reinterpret_cast<const std::uint8_t*>(&header), offsetof(Header, hash));
+}
+
+std::optional<FileStamp> get_file_stamp(const std::filesystem::path& path) {
+	std::error_code ec;
+	const auto size = std::filesystem::file_size(path, ec);
+	if (ec)
+		return std::nullopt;
+	const auto time = std::filesystem::last_write_time(path, ec);
+	if (ec)
+		return std::nullopt;
+	return FileStamp{size, static_cast<std::int64_t>(time.time_since_epoch().count())};
+}
+
+std::optional<Hash> get_partial_hash(const std::filesystem::path& path) {
+	std::vector<std::uint8_t> data(partial_hash_size);
+	std::ifstream ifs{path, std::ios::binary};
+	ifs.read(reinterpret_cast<char*>(data.data()), data.size());
+	if (ifs.bad() || ifs.gcount() <= 0)
+		return std::nullopt;
+	return Hash(data.data(), static_cast<std::size_t>(ifs.gcount()));
+}
+
+// Hash of the whole file at path, as Signature::file_hash, or none if it
+// cannot be read.
+static std::optional<Hash> get_file_hash(const std::filesystem::path& path, const std::uintmax_t size) {
+	if (size == 0)
+		return std::nullopt;
+	std::vector<std::uint8_t> data(static_cast<std::size_t>(size));
+	std::ifstream ifs{path, std::ios::binary};
+	ifs.read(reinterpret_cast<char*>(data.data()), data.size());
+	if (ifs.fail())
+		return std::nullopt;
+	return Hash(data.data(), data.size());
+}
+
+void SignatureCache::load(const std::filesystem::path& path) {
+	std::lock_guard<std::mutex> lg{mutex};
+	map(path);
+}
+
+void SignatureCache::map(const std::filesystem::path& path) {
+	file = MappedFile{};
+	found.clear();
+	n_records = n_contents = 0;
+	index = contents = records = heap = nullptr;
+	heap_size = 0;
+
+	MappedFile mapped{path};
+	Header header;
+	if (mapped.size() < sizeof header)
+		return;
+	std::memcpy(&header, mapped.data(), sizeof header);
+
+	const auto size = mapped.size();
+	const auto is_valid =
+		std::equal(std::begin(header.magic), std::end(header.magic), std::begin(cache_magic)) &&
+		header.version == version &&
+		header.byte_order == cache_byte_order &&
+		header.file_size == size &&
+		get_header_hash(header) == header.hash &&
+		header.index_offset % alignof(IndexEntry) == 0 &&
+		header.records_offset % alignof(Record) == 0 &&
+		header.heap_offset % heap_alignment == 0 &&
+		header.index_offset >= sizeof header &&
+		header.index_offset <= size &&
+		header.n_records <= (size - header.index_offset) / sizeof(IndexEntry) &&
+		header.contents_offset % alignof(ContentEntry) == 0 &&
+		header.contents_offset >= header.index_offset + header.n_records * sizeof(IndexEntry) &&
+		header.contents_offset <= size &&
+		header.n_contents <= (size - header.contents_offset) / sizeof(ContentEntry) &&
+		header.records_offset >= header.contents_offset + header.n_contents * sizeof(ContentEntry) &&
+		header.records_offset <= size &&
+		header.n_records <= (size - header.records_offset) / sizeof(Record) &&
+		header.heap_offset >= header.records_offset + header.n_records * sizeof(Record) &&
+		header.heap_offset <= size;
+	if (!is_valid)
+		return;
+
+	file = std::move(mapped);
+	n_records = static_cast<std::size_t>(header.n_records);
+	index = file.data() + header.index_offset;
+	n_contents = static_cast<std::size_t>(header.n_contents);
+	contents = file.data() + header.contents_offset;
+	records = file.data() + header.records_offset;
+	heap = file.data() + header.heap_offset;
+	heap_size = static_cast<std::size_t>(size - header.heap_offset);
+	found.assign(n_records, false);
+}
+
+std::optional<std::size_t> SignatureCache::find_in_file(const std::string_view path) const {
+	const auto entries_begin = reinterpret_cast<const IndexEntry*>(index);
+	const auto entries_end = entries_begin + n_records;
+	const auto e = std::lower_bound(entries_begin, entries_end, path, [&](const IndexEntry& entry, const std::string_view p) {
+		return get_path(entry, heap, heap_size) < p;
+	});
+	if (e == entries_end || get_path(*e, heap, heap_size) != path)
+		return std::nullopt;
+	return e - entries_begin;
+}
+
+void SignatureCache::set_found(const std::size_t record) const {
+	std::lock_guard<std::mutex> lg{mutex};
+	found[record] = true;
+}
+
+bool SignatureCache::save(const std::filesystem::path& path, const std::chrono::system_clock::time_point now) {
+	std::lock_guard<std::mutex> lg{mutex};
+
+	std::error_code ec;
+	if (path.has_parent_path())
+		std::filesystem::create_directories(path.parent_path(), ec);
+
+	// calls f(path, record, heap, heap size) for the records of file not
+	// replaced nor unused for too long and the entries inserted since,
+	// merged in path order
+	const auto today = get_day(now);
+	const auto index_entries = reinterpret_cast<const IndexEntry*>(index);
+	const auto file_records = reinterpret_cast<const Record*>(records);
+	auto for_each_record = [&](const auto& f) {
+		std::size_t i = 0;
+		auto e = entries.begin();
+		while (i < n_records || e != entries.end()) {
+			const auto file_path = i < n_records ? get_path(index_entries[i], heap, heap_size) : std::string_view{};
+			if (e == entries.end() || (i < n_records && file_path < e->first)) {
+				auto record = file_records[i];
+				if (found[i])
+					record.last_used = today;
+				if (std::uint64_t{record.last_used} + max_unused_days >= today)
+					f(file_path, record, heap, heap_size);
+				i++;
+			} else {
+				if (i < n_records && file_path == e->first)
+					i++;
+				Record record;
+				std::memcpy(&record, e->second.record.data(), sizeof record);
+				f(std::string_view{e->first}, record, e->second.heap.data(), e->second.heap.size());
+				e++;
+			}
+		}
+	};
+
+	// the heap has the path of each record and then its data
+	Header header{};
+	std::copy(std::begin(cache_magic), std::end(cache_magic), std::begin(header.magic));
+	header.version = version;
+	header.byte_order = cache_byte_order;
+	std::uint64_t new_heap_size = 0;
+	std::vector<ContentEntry> new_contents;
+	for_each_record([&](const std::string_view p, Record record, const std::uint8_t*, const std::size_t) {
+		if (!(record.partial_hash == Hash{}))
+			new_contents.push_back({record.stamp.size, record.partial_hash, header.n_records});
+		header.n_records++;
+		new_heap_size += get_aligned(p.size());
+		for (auto ref : get_heap_refs(record))
+			new_heap_size += get_aligned(ref->size);
+	});
+	std::sort(new_contents.begin(), new_contents.end(), [](const ContentEntry& a, const ContentEntry& b) {
+		return std::make_pair(a.file_size, a.partial_hash) < std::make_pair(b.file_size, b.partial_hash);
+	});
+	header.index_offset = sizeof header;
+	header.n_contents = new_contents.size();
+	header.contents_offset = header.index_offset + header.n_records * sizeof(IndexEntry);
+	header.records_offset = header.contents_offset + header.n_contents * sizeof(ContentEntry);
+	header.heap_offset = header.records_offset + header.n_records * sizeof(Record);
+	header.file_size = header.heap_offset + new_heap_size;
+	header.hash = get_header_hash(header);
+
+	auto temporary_path = path;
+	temporary_path += ".tmp";
+	{
+		std::ofstream ofs{temporary_path, std::ios::binary | std::ios::trunc};
+		auto write = [&](const void* const data, const std::size_t size) {
+			ofs.write(static_cast<const char*>(data), size);
+		};
+		write(&header, sizeof header);
+
+		std::uint64_t offset = 0;
+		for_each_record([&](const std::string_view p, Record record, const std::uint8_t*, const std::size_t) {
+			const IndexEntry entry{{offset, p.size()}};
+			write(&entry, sizeof entry);
+			offset += get_aligned(p.size());
+			for (auto ref : get_heap_refs(record))
+				offset += get_aligned(ref->size);
+		});
+
+		write(new_contents.data(), new_contents.size() * sizeof(ContentEntry));
+
+		offset = 0;
+		for_each_record([&](const std::string_view p, Record record, const std::uint8_t*, const std::size_t) {
+			offset += get_aligned(p.size());
+			for (auto ref : get_heap_refs(record)) {
+				ref->offset = offset;
+				offset += get_aligned(ref->size);
+			}
+			write(&record, sizeof record);
+		});
+
+		// each followed by zeros to the alignment, and data of damaged
+		// records that is not in their heap is zeros
+		std::vector<std::uint8_t> zeros;
+		auto write_zeros = [&](const std::uint64_t size) {
+			zeros.resize(static_cast<std::size_t>(size));
+			write(zeros.data(), zeros.size());
+		};
+		for_each_record([&](const std::string_view p, Record record, const std::uint8_t* const h, const std::size_t h_size) {
+			write(p.data(), p.size());
+			write_zeros(get_aligned(p.size()) - p.size());
+			for (auto ref : get_heap_refs(record)) {
+				if (is_in_heap(*ref, h_size))
+					write(h + ref->offset, static_cast<std::size_t>(ref->size));
+				else
+					write_zeros(ref->size);
+				write_zeros(get_aligned(ref->size) - ref->size);
+			}
+		});
+
+		ofs.close();
+		if (!ofs || !flush_file(temporary_path)) {
+			std::filesystem::remove(temporary_path, ec);
+			return false;
+		}
+	}
+
+	// a mapped file cannot be renamed over on Windows
+	file = MappedFile{};
+	std::filesystem::rename(temporary_path, path, ec);
+	if (ec) {
+		std::filesystem::remove(temporary_path, ec);
+		map(path);
+		return false;
+	}
+
+	map(path);
+	if (n_records == header.n_records) {
+		entries.clear();
+		entry_paths.clear();
+	}
+	return true;
+}
+
+template<typename F>
+bool SignatureCache::find_record(const std::string_view path, const FileStamp& stamp, const F& f) const {
+	// an entry inserted since is read with mutex locked, the file stays
+	// mapped as it is until save()
+	{
+		std::lock_guard<std::mutex> lg{mutex};
+		if (const auto e = entries.find(path); e != entries.end()) {
+			Record record;
+			std::memcpy(&record, e->second.record.data(), sizeof record);
+			if (!(record.stamp == stamp))
+				return false;
+			const auto view = get_view(record, path, e->second.heap.data(), e->second.heap.size());
+			if (!view)
+				return false;
+			f(record, *view);
+			return true;
+		}
+	}
+
+	const auto i = find_in_file(path);
+	if (!i)
+		return false;
+	const auto& record = reinterpret_cast<const Record*>(records)[*i];
+	if (!(record.stamp == stamp))
+		return false;
+	const auto view = get_view(record, path, heap, heap_size);
+	if (!view)
+		return false;
+	f(record, *view);
+	set_found(*i);
+	return true;
+}
+
+std::shared_ptr<Signature> SignatureCache::find(const std::filesystem::path& path, const FileStamp& stamp) const {
+	std::shared_ptr<Signature> signature;
+	find_record(get_key(path), stamp, [&](const Record& record, const ImageTable::SignatureView& view) {
+		signature = read_signature(record, view);
+	});
+	return signature;
+}
+
+bool SignatureCache::find(const std::filesystem::path& path, const FileStamp& stamp, ImageTable& table, const std::uint32_t id) const {
+	// on Windows, paths are UTF-16 and so converted
+	#ifdef _WIN32
+		const auto key = get_key(path);
+	#else
+		const std::string_view key = path.native();
+	#endif
+	return find_record(key, stamp, [&](const Record&, const ImageTable::SignatureView& view) {
+		table.set(id, view);
+	});
+}
+
+std::shared_ptr<Signature> SignatureCache::find_by_content(const std::filesystem::path& path, const FileStamp& stamp) const {
+	const auto partial_hash = get_partial_hash(path);
+	if (!partial_hash)
+		return nullptr;
+	const Content content{stamp.size, *partial_hash};
+
+	// entries and records of that content, which may then have other paths
+	struct Candidate {
+		std::string path;
+		Entry entry; // or
+		const Record* record;
+	};
+	std::vector<Candidate> candidates;
+	{
+		std::lock_guard<std::mutex> lg{mutex};
+		const auto [begin, end] = entry_paths.equal_range(content);
+		for (auto i = begin; i != end; i++)
+			if (const auto e = entries.find(i->second); e != entries.end())
+				candidates.push_back({i->second, e->second, nullptr});
+	}
+	const auto contents_begin = reinterpret_cast<const ContentEntry*>(contents);
+	const auto contents_end = contents_begin + n_contents;
+	const auto [begin, end] = std::equal_range(contents_begin, contents_end, ContentEntry{content.first, content.second, 0}, [](const ContentEntry& a, const ContentEntry& b) {
+		return std::make_pair(a.file_size, a.partial_hash) < std::make_pair(b.file_size, b.partial_hash);
+	});
+	for (auto i = begin; i != end; i++) {
+		if (i->record >= n_records)
+			continue;
+		const auto index_entry = reinterpret_cast<const IndexEntry*>(index)[i->record];
+		candidates.push_back({std::string{get_path(index_entry, heap, heap_size)}, {}, reinterpret_cast<const Record*>(records) + i->record});
+	}
+	if (candidates.empty())
+		return nullptr;
+
+	const auto file_hash = get_file_hash(path, stamp.size);
+	if (!file_hash)
+		return nullptr;
+	for (const auto& c : candidates) {
+		Record record;
+		std::memcpy(&record, c.record ? static_cast<const void*>(c.record) : c.entry.record.data(), sizeof record);
+		if (!(record.file_hash == *file_hash) || record.stamp.size != stamp.size)
+			continue;
+		const auto view = c.record
+			? get_view(record, c.path, heap, heap_size)
+			: get_view(record, c.path, c.entry.heap.data(), c.entry.heap.size());
+		if (!view)
+			continue;
+		if (c.record)
+			set_found(c.record - reinterpret_cast<const Record*>(records));
+		return read_signature(record, *view);
+	}
+	return nullptr;
+}
+
+void SignatureCache::insert(const std::filesystem::path& path, const FileStamp& stamp, const Signature& signature) {
+	assert(!path.empty());
+
+	if (signature.status == Signature::Status::open_failed)
+		return;
+
+	const auto key = get_key(path);
+	const auto partial_hash = get_partial_hash(path);
+	Entry entry;
+	write_record(key, stamp, partial_hash.value_or(Hash{}), signature, entry.record, entry.heap);
+
+	std::lock_guard<std::mutex> lg{mutex};
+	entries[key] = std::move(entry);
+	if (partial_hash) {
+		const Content content{stamp.size, *partial_hash};
+		const auto [begin, end] = entry_paths.equal_range(content);
+		if (std::none_of(begin, end, [&](const auto& p) { return p.second == key; }))
+			entry_paths.emplace(content, key);
+	}
+}
+
+std::size_t SignatureCache::size() const {
+	std::lock_guard<std::mutex> lg{mutex};
+	auto n = n_records;
+	for (const auto& e : entries)
+		n += !find_in_file(e.first);
+	return n;
+}
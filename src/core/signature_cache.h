@@ -0,0 +1,143 @@
+#pragma once
+
+#include "image_table.h"
+#include "mapped_file.h"
+#include "signature.h"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Size and last write time of a file, which identify its content well
+// enough to reuse what was computed from it.
+struct FileStamp {
+	std::uintmax_t size;
+	std::int64_t time; // ticks of std::filesystem::file_time_type
+
+	bool operator==(const FileStamp& rhs) const {
+		return size == rhs.size && time == rhs.time;
+	}
+};
+
+// Stamp of the file at path, or none if it cannot be read.
+std::optional<FileStamp> get_file_stamp(const std::filesystem::path& path);
+
+// Hash of the first partial_hash_size bytes of the file at path, or none if
+// it cannot be read or is empty. Files with different partial hashes have
+// different contents, and so files of the same size usually do, without
+// reading them whole.
+const std::size_t partial_hash_size = 64 * 1024;
+std::optional<Hash> get_partial_hash(const std::filesystem::path& path);
+
+// Signatures kept on disk between scans, by path, for as long as the file
+// keeps its FileStamp, so that unchanged files need not be decoded again.
+// A signature is kept as its intensity arrays, image size, metadata and
+// hashes. Entries may be found and inserted concurrently.
+//
+// Signatures are also found by content, for files moved, renamed or copied
+// since they were cached: by file size and partial hash and then confirmed
+// by the hash of the whole file, which is the one read that it then takes.
+//
+// The file is columnar: a header, an index of paths in path order, an
+// index of contents (file size and partial hash) in content order, an
+// array of fixed-size records (one per path, in path order) and a heap of
+// the paths and the variable-size metadata the records refer to. It is
+// mapped rather than read, so loading takes no time whatever its size and
+// concurrent processes share its pages, and is searched in place. Entries
+// inserted since are kept apart, serialized the same way, until save().
+//
+// Records and heap data are aligned, so a hit is read in place too: the
+// record is hashed where it is, and find() into a table sets the row from
+// its intensities and metadata without allocating a Signature or copying
+// them first. Only find() of a Signature copies them into one.
+//
+// The file is only ever replaced whole: save() writes a new file, flushes
+// it to the disk and then renames it over the old one. A file of another
+// version or with a damaged header is ignored, and a record is hashed with
+// the path and the heap data it refers to and ignored if damaged, so a
+// crash can only lose entries.
+//
+// Each record keeps the day it was last found or inserted, and save() drops
+// those unused for max_unused_days, so that entries of files deleted or no
+// longer scanned do not accumulate.
+class SignatureCache {
+public:
+	// Bump when the format or the computation of signatures changes.
+	static const std::uint32_t version = 5;
+
+	static const std::uint32_t max_unused_days = 90;
+
+	// Maps the file at path, if there is one, replacing any file mapped
+	// before but not entries inserted since.
+	void load(const std::filesystem::path& path);
+
+	// Writes the entries used since max_unused_days before now to the file
+	// at path, creating its folder, and then maps it. Returns false, leaving
+	// any previous file as it was, if that fails. Not to be called
+	// concurrently with find() or insert().
+	bool save(const std::filesystem::path& path, std::chrono::system_clock::time_point now = std::chrono::system_clock::now());
+
+	// Signature of the file at path if cached with the same stamp.
+	std::shared_ptr<Signature> find(const std::filesystem::path& path, const FileStamp& stamp) const;
+
+	// As above, but sets row id of table to the signature, if found, as it
+	// is in the file, and returns whether it was.
+	bool find(const std::filesystem::path& path, const FileStamp& stamp, ImageTable& table, const std::uint32_t id) const;
+
+	// Signature of a file of any path with the same content as the file at
+	// path, which is read to find it if another file has the same size and
+	// partial hash.
+	std::shared_ptr<Signature> find_by_content(const std::filesystem::path& path, const FileStamp& stamp) const;
+
+	// Adds or replaces the entry of path, unless the file could not be
+	// opened, which may well not last. Reads the start of the file for its
+	// partial hash.
+	void insert(const std::filesystem::path& path, const FileStamp& stamp, const Signature& signature);
+
+	std::size_t size() const;
+
+private:
+	// A record (see signature_cache.cpp) and the heap it refers to.
+	struct Entry {
+		std::vector<std::uint8_t> record;
+		std::vector<std::uint8_t> heap;
+	};
+
+	// As load(), with mutex locked.
+	void map(const std::filesystem::path& path);
+
+	// Number of the record of path in file, if any.
+	std::optional<std::size_t> find_in_file(const std::string_view path) const;
+
+	// Calls f(record, view) with the record of path, read in place, and
+	// returns true if it is cached with stamp and not damaged.
+	template<typename F>
+	bool find_record(const std::string_view path, const FileStamp& stamp, const F& f) const;
+
+	// Marks record of file as used.
+	void set_found(const std::size_t record) const;
+
+	using Content = std::pair<std::uint64_t, Hash>; // file size and partial hash
+
+	mutable std::mutex mutex;
+	MappedFile file;
+	std::size_t n_records = 0;
+	const std::uint8_t* index = nullptr; // of file
+	std::size_t n_contents = 0;
+	const std::uint8_t* contents = nullptr; // of file
+	const std::uint8_t* records = nullptr; // of file
+	const std::uint8_t* heap = nullptr; // of file
+	std::size_t heap_size = 0;
+	mutable std::vector<bool> found; // of the records of file, since mapped
+	std::map<std::string, Entry, std::less<>> entries; // by UTF-8 path, inserted since loaded
+	std::multimap<Content, std::string> entry_paths; // of entries, by content
+};
@@ -0,0 +1,36 @@
+#include "simd.h"
+
+#if defined(SIMD_X86) && defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+
+#ifdef SIMD_X86
+static bool is_avx2_supported() {
+	#ifdef _MSC_VER
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7)
+			return false;
+
+		// avx and os support for saving ymm registers
+		__cpuid(info, 1);
+		const auto osxsave_avx = (1 << 27) | (1 << 28);
+		if ((info[2] & osxsave_avx) != osxsave_avx || (_xgetbv(0) & 6) != 6)
+			return false;
+
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+	#else
+		return __builtin_cpu_supports("avx2");
+	#endif
+}
+#endif
+
+SimdLevel get_simd_level() {
+	#ifdef SIMD_X86
+		static const auto level = is_avx2_supported() ? SimdLevel::avx2 : SimdLevel::sse2;
+		return level;
+	#else
+		return SimdLevel::scalar;
+	#endif
+}
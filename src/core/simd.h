@@ -0,0 +1,19 @@
+#pragma once
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+	#define SIMD_X86
+	#include <immintrin.h>
+#endif
+
+#if defined(SIMD_X86) && defined(__GNUC__)
+	#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+	#define TARGET_AVX2
+#endif
+
+// Instruction sets of the vectorised kernels, in order of preference. SSE2
+// is always available on x86 builds, AVX2 is detected at run time.
+enum class SimdLevel {scalar, sse2, avx2};
+
+// Best level supported by this processor (and build).
+SimdLevel get_simd_level();
@@ -0,0 +1,80 @@
+#include "summed_area_table.h"
+
+#include "../shared/assert.h"
+
+#include <algorithm>
+
+static void sort_unique(std::vector<std::uint32_t>& v) {
+	std::sort(v.begin(), v.end());
+	v.erase(std::unique(v.begin(), v.end()), v.end());
+}
+
+SummedAreaTable::SummedAreaTable(
+	const std::uint8_t* const pixel_buffer,
+	[[maybe_unused]] const PixelSize& size,
+	const int line_stride,
+	std::vector<std::uint32_t> column_boundaries,
+	std::vector<std::uint32_t> row_boundaries
+)
+	:
+	column_boundaries{column_boundaries},
+	row_boundaries{row_boundaries}
+{
+	sort_unique(this->column_boundaries);
+	sort_unique(this->row_boundaries);
+
+	const auto& cb = this->column_boundaries;
+	const auto& rb = this->row_boundaries;
+
+	assert(cb.size() >= 2 && cb.front() == 0 && cb.back() == size.w);
+	assert(rb.size() >= 2 && rb.front() == 0 && rb.back() == size.h);
+
+	const auto n_columns = cb.size();
+	const auto n_rows = rb.size();
+	table.assign(n_columns * n_rows, Sums{});
+
+	// accumulate each grid cell in one pass over the pixels, row by row
+
+	std::vector<Sums> row_cell_sums(n_columns - 1);
+
+	for (std::size_t cy = 0; cy + 1 < n_rows; cy++) {
+		std::fill(row_cell_sums.begin(), row_cell_sums.end(), Sums{});
+
+		for (auto y = rb[cy]; y < rb[cy + 1]; y++) {
+			const auto line = pixel_buffer + static_cast<std::size_t>(y) * line_stride;
+
+			for (std::size_t cx = 0; cx + 1 < n_columns; cx++)
+				add_channel_sums(line + cb[cx] * 4, cb[cx + 1] - cb[cx], row_cell_sums[cx]);
+		}
+
+		// integrate into the table
+		for (std::size_t cx = 0; cx + 1 < n_columns; cx++) {
+			const auto& above_left = table[cy * n_columns + cx];
+			const auto& above = table[cy * n_columns + cx + 1];
+			const auto& left = table[(cy + 1) * n_columns + cx];
+			auto& corner = table[(cy + 1) * n_columns + cx + 1];
+			for (auto c = 0; c < 4; c++)
+				corner[c] = row_cell_sums[cx][c] + above[c] + left[c] - above_left[c];
+		}
+	}
+}
+
+SummedAreaTable::Sums SummedAreaTable::get_sums(const PixelRect& rect) const {
+	const auto& tl = get_corner(rect.left, rect.top);
+	const auto& tr = get_corner(rect.right, rect.top);
+	const auto& bl = get_corner(rect.left, rect.bottom);
+	const auto& br = get_corner(rect.right, rect.bottom);
+
+	Sums sums;
+	for (auto c = 0; c < 4; c++)
+		sums[c] = br[c] - tr[c] - bl[c] + tl[c];
+	return sums;
+}
+
+const SummedAreaTable::Sums& SummedAreaTable::get_corner(const std::uint32_t x, const std::uint32_t y) const {
+	auto i = std::lower_bound(column_boundaries.begin(), column_boundaries.end(), x) - column_boundaries.begin();
+	auto j = std::lower_bound(row_boundaries.begin(), row_boundaries.end(), y) - row_boundaries.begin();
+	assert(static_cast<std::size_t>(i) < column_boundaries.size() && column_boundaries[i] == x);
+	assert(static_cast<std::size_t>(j) < row_boundaries.size() && row_boundaries[j] == y);
+	return table[j * column_boundaries.size() + i];
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "channel_sums.h"
+#include "signature.h"
+
+#include <cstdint>
+#include <vector>
+
+// Summed-area table of the B, G, R and A channels of a 32 bpp BGRA pixel
+// buffer, at the resolution of a grid of column and row boundaries rather
+// than of pixels. It is built in a single pass over the pixels, after which
+// the channel sums of any rectangle with edges on the grid take constant
+// time to look up.
+class SummedAreaTable {
+public:
+	using Sums = ChannelSums;
+
+	// Boundaries are sorted and made unique, and must include 0 and the
+	// width (columns) or height (rows) of the image.
+	SummedAreaTable(
+		const std::uint8_t* const pixel_buffer,
+		const PixelSize& size,
+		const int line_stride,
+		std::vector<std::uint32_t> column_boundaries,
+		std::vector<std::uint32_t> row_boundaries);
+
+	// Channel sums of rect, whose edges must be grid boundaries.
+	Sums get_sums(const PixelRect& rect) const;
+
+private:
+	std::vector<std::uint32_t> column_boundaries;
+	std::vector<std::uint32_t> row_boundaries;
+
+	// sums over [0, column_boundaries[i]) x [0, row_boundaries[j]) at
+	// j * column_boundaries.size() + i
+	std::vector<Sums> table;
+
+	const Sums& get_corner(const std::uint32_t x, const std::uint32_t y) const;
+};
@@ -1,26 +1,36 @@
-#pragma once
-
-#include "image.h"
-
-#include <chrono>
-#include <memory>
-#include <string>
-
-class ImagePair {
-public:
-	std::shared_ptr<Image> image_1;
-	std::shared_ptr<Image> image_2;
-	float distance;
-
-	ImagePair(
-		const std::shared_ptr<Image>& image_1,
-		const std::shared_ptr<Image>& image_2);
-
-	bool operator<(const ImagePair& rhs) const;
-
-	bool is_in_same_folder() const;
-	std::chrono::system_clock::duration get_age() const;
-	std::chrono::system_clock::duration time_distance() const;
-	float location_distance() const;
-	std::wstring description() const;
-};
+#pragma once
+
+#include "image.h"
+
+#include "core/job.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Pair of images found by process(), as ids into ImagePairs::images.
+using ImagePair = SignaturePair;
+
+// Images of a scan and the pairs of them in each category (see Category),
+// sorted by distance and then by path. A pair is only two ids and a
+// distance, so that millions of pairs neither copy nor count references
+// to their images.
+class ImagePairs {
+public:
+	std::vector<std::shared_ptr<Image>> images; // in path order
+	std::vector<std::vector<ImagePair>> categories{n_categories};
+
+	// images of pair, older first
+	const std::shared_ptr<Image>& image_1(const ImagePair& pair) const;
+	const std::shared_ptr<Image>& image_2(const ImagePair& pair) const;
+
+	bool is_in_same_folder(const ImagePair& pair) const;
+	std::chrono::system_clock::duration get_age(const ImagePair& pair) const;
+	std::chrono::system_clock::duration time_distance(const ImagePair& pair) const;
+	float location_distance(const ImagePair& pair) const;
+	std::wstring description(const ImagePair& pair) const;
+
+private:
+	bool is_swapped(const ImagePair& pair) const;
+};
@@ -1,256 +1,257 @@
-#include "shared.h"
-
-#include "image.h"
-#include "image_pair.h"
-#include "job.h"
-#include "time.h"
-#include "window.h"
-
-#include "shared/vector.h"
-
-#include <algorithm>
-#include <mutex>
-#include <sstream>
-#include <vector>
-
-static void thread_worker(Job* const job) {
-	TRACE();
-
-	er = CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED);
-
-	for (;;) {
-		auto ip = job->get_next_pair();
-		const auto i1 = ip.image_1;
-		const auto i2 = ip.image_2;
-
-		bool quit =
-			i1 == nullptr ||
-			i2 == nullptr ||
-			job->force_thread_exit ||
-			!ErrorReflector::is_good();
-		if (quit)
-			break;
-
-		if (i1 == i2)
-			continue;
-
-		auto images_ok =
-			i1->get_status() == Image::Status::ok &&
-			i2->get_status() == Image::Status::ok;
-		if (!images_ok)
-			continue;
-
-		auto distance_combined = 0.0f;
-		auto distance_combined_min = 0.0f;
-		auto distance_combined_max = 0.0f;
-
-		// TODO: Magic numbers related to image pair similarity scoring below; should be refactored once it has stabilized.
-
-		// score visual similarity
-		const auto distance_visual_max = 0.6f;
-		auto [distance_visual, aspect_ratio_flipped, cropped] =	distance(*i1, *i2, distance_visual_max);
-
-		// score time
-		auto distance_time = std::numeric_limits<float>::max();
-		auto n_images_with_metadata_times =
-			!i1->get_metadata_times().empty() +
-			!i2->get_metadata_times().empty();
-		if (n_images_with_metadata_times == 1) {
-			distance_combined += 1;
-		} else if (n_images_with_metadata_times == 2) {
-			auto duration_min = ip.time_distance();
-			assert(duration_min != std::chrono::system_clock::duration::max());
-
-			if (duration_min != std::chrono::system_clock::duration::max())
-				distance_time = std::chrono::duration<float>(duration_min).count();
-
-			if (duration_min < 2*24h)
-				distance_combined += -5 * (1 - std::chrono::duration<float>(duration_min).count() / (2*24*3600));
-			else if (duration_min > 20*24h)
-				distance_combined += 5;
-		}
-		distance_combined_min += -5;
-		distance_combined_max += 5;
-
-		// score location
-		auto distance_location = std::numeric_limits<float>::max();
-		auto p1 = i1->get_metadata_position();
-		auto p2 = i2->get_metadata_position();
-		auto n_images_with_metadata_locations =
-			(p1.x != 0 && p1.y != 0) +
-			(p2.x != 0 && p2.y != 0);
-		if (n_images_with_metadata_locations == 1) {
-			distance_combined += 1;
-		} else if (n_images_with_metadata_locations == 2) {
-			auto d = ip.location_distance();
-			distance_location = d;
-			if (d < 10*1000)
-				distance_combined += -5*pow(1 - d / (10*1000), 2);
-			else if (d > 100*1000)
-				distance_combined += 5;
-		}
-		distance_combined_min += -5;
-		distance_combined_max += 5;
-
-		// score make and model
-		if (i1->get_metadata_make_model() == i2->get_metadata_make_model()) {
-			if (i1->get_metadata_make_model().empty())
-				distance_combined += 0; // both empty
-			else
-				distance_combined += -2; // both set and equal
-		} else {
-			if (i1->get_metadata_make_model().empty() || i2->get_metadata_make_model().empty())
-				distance_combined += 1; // only one set
-			else
-				distance_combined += 5; // both set but different
-		}
-		distance_combined_min += -2;
-		distance_combined_max += 5;
-
-		// score camera id
-		if (i1->get_metadata_camera_id() == i2->get_metadata_camera_id()) {
-			if (i1->get_metadata_camera_id().empty())
-				distance_combined += 0;
-			else
-				distance_combined += -2;
-		} else {
-			if (i1->get_metadata_camera_id().empty() || i2->get_metadata_camera_id().empty())
-				distance_combined += 1;
-			else
-				distance_combined += 5;
-		}
-		distance_combined_min += -2;
-		distance_combined_max += 5;
-
-		// score image id
-		if (i1->get_metadata_image_id() == i2->get_metadata_image_id()) {
-			if (i1->get_metadata_image_id().empty())
-				distance_combined += 0;
-			else
-				distance_combined += -10;
-		} else {
-			if (i1->get_metadata_image_id().empty() || i2->get_metadata_image_id().empty())
-				distance_combined += 2;
-			else
-				distance_combined += 10;
-		}
-		distance_combined_min += -10;
-		distance_combined_max += 10;
-
-		// score dimensions
-		auto ar1 = static_cast<float>(i1->get_image_size().w) / i1->get_image_size().h;
-		auto ar2 = static_cast<float>(i2->get_image_size().w) / i2->get_image_size().h;
-		if (aspect_ratio_flipped)
-			ar1 = 1/ar1;
-		if (ar1 < 1) {
-			ar1 = 1/ar1;
-			ar2 = 1/ar2;
-		}
-		if (!cropped)
-			distance_combined += std::min(10.0f*std::sqrt(std::abs(ar1 - ar2)), 10.0f);
-		distance_combined_min += 0;
-		distance_combined_max += 10;
-
-		// normalize distance
-		distance_combined = (distance_combined - distance_combined_min) /
-			(distance_combined_max - distance_combined_min);
-
-		auto visual_fraction = 0.6f;
-		distance_combined = visual_fraction * distance_visual + (1-visual_fraction) * distance_combined;
-
-		// add image pairs to relevant image pair categories
-
-		std::lock_guard<std::mutex> lg{job->pairs_mutex};
-
-		if (distance_time < 12*3600) {
-			ip.distance = distance_time;
-			job->pairs_time.push_back(ip);
-		}
-		if (distance_location < 10*1000) {
-			ip.distance = distance_location;
-			job->pairs_location.push_back(ip);
-		}
-
-		bool aspect_ratios_too_dissimilar = ar1/ar2 > 1.75f || ar2/ar1 > 1.75f;
-		bool aspect_ratios_inverses = std::abs(1/ar1 - ar2) < 0.01f;
-		if (aspect_ratios_too_dissimilar && !aspect_ratios_inverses && !cropped)
-			continue;
-
-		if (distance_visual < 0.37f) {
-			ip.distance = distance_visual;
-			job->pairs_visual.push_back(ip);
-		}
-		if (distance_combined < 0.37f) {
-			ip.distance = distance_combined;
-			job->pairs_combined.push_back(ip);
-		}
-	}
-
-	CoUninitialize();
-	TRACE();
-}
-
-std::vector<std::vector<ImagePair>> process(Window& window, const std::vector<std::filesystem::path>& paths) {
-	// prepare job
-	std::vector<std::vector<ImagePair>> pair_categories{4};
-	Job job{
-		paths,
-		pair_categories[0],
-		pair_categories[1],
-		pair_categories[2],
-		pair_categories[3]};
-
-	debug_timer_reset();
-
-	// create workers
-	std::vector<std::thread> threads{std::thread::hardware_concurrency()};
-	for (auto& t : threads)
-		t = std::thread(thread_worker, &job);
-
-	// update progress bar until no more work or window requests that work be stopped
-	auto start = std::chrono::system_clock::now();
-	auto last_update = std::chrono::system_clock::time_point{};
-	while (!job.is_completed()) {
-		if (auto e = window.get_event(); e.type == Event::Type::quit || e.type == Event::Type::button) {
-			job.force_thread_exit = true;
-			break;
-		}
-
-		window.set_progressbar_progress(0, job.get_progress());
-
-		if (auto now = std::chrono::system_clock::now(); now - last_update > 1s) {
-			last_update = now;
-
-			std::wostringstream ss;
-			ss.imbue(std::locale(""));
-			ss << L"Processing " << paths.size() << L" images";
-
-			if (auto elapsed = now - start; elapsed > 2s && job.get_progress() > 0) {
-				auto total = std::chrono::duration_cast<std::chrono::system_clock::duration>(elapsed / job.get_progress());
-				ss << L": " << total - elapsed << L" remaining";
-				debug_log << total << "\n";
-			}
-			window.set_text(1, ss.str(), {}, true);
-		}
-	}
-
-	// wait for threads to exit
-	for (auto& thread : threads)
-		thread.join();
-
-	// return nothing if work not complete
-	if (job.force_thread_exit)
-		return {{}, {}, {}, {}};
-
-	window.set_text(1, L"Sorting results", {}, true);
-	window.has_event();
-
-	window.set_progressbar_progress(0, -1.0f);
-	for (auto& d : pair_categories)
-		sort(d.begin(), d.end());
-
-	debug_log << L"process time: " << debug_timer() << std::endl;
-	debug_log << L"comparisons (calculated): " << (paths.size()*paths.size() - paths.size())/2 << std::endl;
-
-	return pair_categories;
-}
+#include "shared.h"
+
+#include "image.h"
+#include "image_pair.h"
+#include "scan.h"
+#include "time.h"
+#include "window.h"
+
+#include "core/job.h"
+#include "core/scan_state.h"
+#include "core/signature_cache.h"
+
+#include "shared/vector.h"
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ShlObj.h>
+
+static void decode_worker(Job* const job) {
+	TRACE();
+
+	er = CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED);
+	job->decode();
+	CoUninitialize();
+
+	TRACE();
+}
+
+static void compare_worker(Job* const job) {
+	TRACE();
+
+	job->work();
+
+	TRACE();
+}
+
+// %LOCALAPPDATA%\Pixiple\file_name, or empty if there is no such folder
+static std::filesystem::path get_app_data_path(const wchar_t* const file_name) {
+	PWSTR folder;
+	if (FAILED(SHGetKnownFolderPath(FOLDERID_LocalAppData, 0, nullptr, &folder))) {
+		CoTaskMemFree(folder);
+		return {};
+	}
+	std::filesystem::path path{folder};
+	CoTaskMemFree(folder);
+	return path / L"Pixiple" / file_name;
+}
+
+// Images and pairs of the last scan, as process() left them, without
+// comparing any images, or nothing if there are none or reopening is
+// cancelled. Images unchanged since are decoded only if no longer cached.
+// Images changed or removed since are left out, and so are their pairs,
+// and how many is shown.
+ImagePairs reopen(Window& window) {
+	add_progress_panes(window, L"Loading last scan");
+	window.has_event();
+
+	debug_timer_reset();
+
+	ScanState state;
+	const auto state_path = get_app_data_path(L"scan.state");
+	if (state_path.empty() || !state.load(state_path))
+		return {};
+	SignatureCache cache;
+	const auto cache_path = get_app_data_path(L"signatures.cache");
+	if (!cache_path.empty())
+		cache.load(cache_path);
+
+	// images unchanged since, with their cached signatures or decoded again
+	std::vector<std::shared_ptr<Image>> images(state.paths.size());
+	std::atomic<std::size_t> index_next = 0;
+	std::atomic<std::size_t> n_completed = 0;
+	std::atomic<std::size_t> n_decoded = 0;
+	std::atomic<bool> stopped = false;
+	auto worker = [&] {
+		er = CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED);
+		for (;;) {
+			const auto i = index_next++;
+			if (i >= images.size() || stopped)
+				break;
+			const auto stamp = get_file_stamp(state.paths[i]);
+			if (stamp && state.stamps[i] && *stamp == *state.stamps[i]) {
+				if (const auto signature = cache.find(state.paths[i], *stamp)) {
+					images[i] = std::make_shared<Image>(state.paths[i], *signature);
+				} else {
+					const auto decoded = Image::decode(state.paths[i]);
+					cache.insert(state.paths[i], *stamp, decoded);
+					images[i] = std::make_shared<Image>(state.paths[i], decoded);
+					n_decoded++;
+				}
+			}
+			n_completed++;
+		}
+		CoUninitialize();
+	};
+	std::vector<std::thread> threads;
+	for (auto i = 0u; i < std::max(std::thread::hardware_concurrency(), 1u); i++)
+		threads.push_back(std::thread(worker));
+	while (n_completed < images.size()) {
+		if (window.has_event()) {
+			if (auto e = window.get_event(); e.type == Event::Type::quit || e.type == Event::Type::button) {
+				stopped = true;
+				break;
+			}
+		}
+		window.set_progressbar_progress(0, static_cast<float>(n_completed) / images.size());
+		std::this_thread::sleep_for(100ms);
+	}
+	for (auto& thread : threads)
+		thread.join();
+	if (n_decoded > 0 && !cache_path.empty())
+		cache.save(cache_path);
+	if (stopped)
+		return {};
+
+	// pairs of those images, reindexed to them
+	std::vector<std::filesystem::path> paths;
+	std::vector<std::optional<FileStamp>> stamps;
+	ImagePairs image_pairs;
+	for (std::size_t i = 0; i < images.size(); i++) {
+		if (images[i]) {
+			paths.push_back(state.paths[i]);
+			stamps.push_back(state.stamps[i]);
+			image_pairs.images.push_back(std::move(images[i]));
+		}
+	}
+	image_pairs.categories = get_compared_pairs(state, paths, stamps, state.options).pair_categories;
+
+	debug_log << L"reopen time: " << debug_timer() << std::endl;
+
+	if (const auto n_left_out = state.paths.size() - paths.size(); n_left_out > 0) {
+		std::wostringstream ss;
+		ss.imbue(std::locale(""));
+		ss << n_left_out << L" of the " << state.paths.size() << L" images of the last scan have changed or been removed since, and are left out with their pairs. Scan again to compare them.";
+		window.message_box(ss.str());
+	}
+
+	return image_pairs;
+}
+
+ImagePairs process(Window& window, const std::vector<std::filesystem::path>& paths, const ThreadCounts& n_threads) {
+	// signatures of images unchanged since an earlier scan, also if moved or
+	// copied, are not computed again, and pairs of them not compared again
+	window.set_text(1, L"Loading earlier scan", {}, true);
+	window.has_event();
+	assert(std::is_sorted(paths.begin(), paths.end()));
+	std::vector<std::optional<FileStamp>> stamps(paths.size());
+	std::transform(paths.begin(), paths.end(), stamps.begin(), get_file_stamp);
+	SignatureCache cache;
+	const auto cache_path = get_app_data_path(L"signatures.cache");
+	if (!cache_path.empty())
+		cache.load(cache_path);
+	ComparedPairs compared;
+	const auto state_path = get_app_data_path(L"scan.state");
+	if (ScanState state; !state_path.empty() && state.load(state_path))
+		compared = get_compared_pairs(state, paths, stamps, {});
+
+	// prepare job; pairs are sorted by image index as path rank
+	ImagePairs image_pairs;
+	image_pairs.images.resize(paths.size());
+	// images keep only the info of their signatures, the rest is only in
+	// the table
+	Job job{paths.size(), [&](const std::uint32_t i, ImageTable& table) {
+		const auto& stamp = stamps[i];
+		auto signature = stamp ? cache.find(paths[i], *stamp) : nullptr;
+		const auto is_cached_by_path = signature != nullptr;
+		if (stamp && !signature)
+			signature = cache.find_by_content(paths[i], *stamp);
+		if (!signature)
+			signature = std::make_shared<Signature>(Image::decode(paths[i]));
+		if (stamp && !is_cached_by_path)
+			cache.insert(paths[i], *stamp, *signature);
+		image_pairs.images[i] = std::make_shared<Image>(paths[i], *signature);
+		table.set(i, *signature);
+	}, {}, std::move(compared)};
+
+	debug_timer_reset();
+
+	// create workers
+	std::vector<std::thread> threads;
+	for (auto i = 0u; i < n_threads.decode; i++)
+		threads.push_back(std::thread(decode_worker, &job));
+	for (auto i = 0u; i < n_threads.compare; i++)
+		threads.push_back(std::thread(compare_worker, &job));
+
+	// update progress bar until no more work or window requests that work be stopped
+	auto start = std::chrono::system_clock::now();
+	auto last_update = std::chrono::system_clock::time_point{};
+	while (!job.is_completed()) {
+		if (!ErrorReflector::is_good()) {
+			job.stop();
+			break;
+		}
+
+		if (auto e = window.get_event(); e.type == Event::Type::quit || e.type == Event::Type::button) {
+			job.stop();
+			break;
+		}
+
+		window.set_progressbar_progress(0, job.get_progress());
+
+		if (auto now = std::chrono::system_clock::now(); now - last_update > 1s) {
+			last_update = now;
+
+			std::wostringstream ss;
+			ss.imbue(std::locale(""));
+			ss << L"Processing " << paths.size() << L" images";
+
+			if (auto elapsed = now - start; elapsed > 2s && job.get_progress() > 0) {
+				auto total = std::chrono::duration_cast<std::chrono::system_clock::duration>(elapsed / job.get_progress());
+				ss << L": " << total - elapsed << L" remaining";
+				debug_log << total << "\n";
+			}
+			window.set_text(1, ss.str(), {}, true);
+		}
+	}
+
+	// wait for threads to exit
+	for (auto& thread : threads)
+		thread.join();
+
+	// keep the signatures computed, also of work stopped
+	if (!cache_path.empty()) {
+		window.set_text(1, L"Saving signatures", {}, true);
+		window.has_event();
+		cache.save(cache_path);
+	}
+
+	// return nothing if work not complete
+	if (job.is_stopped())
+		return {};
+
+	window.set_text(1, L"Sorting results", {}, true);
+	window.has_event();
+
+	window.set_progressbar_progress(0, -1.0f);
+	image_pairs.categories = std::move(job.get_pair_categories());
+
+	if (!state_path.empty()) {
+		window.set_text(1, L"Saving pairs", {}, true);
+		window.has_event();
+		ScanState{{}, paths, stamps, image_pairs.categories}.save(state_path);
+	}
+
+	debug_log << L"process time: " << debug_timer() << std::endl;
+	debug_log << L"comparisons (calculated): " << (paths.size()*paths.size() - paths.size())/2 << std::endl;
+
+	return image_pairs;
+}
@@ -1,7 +1,7 @@
-#pragma once
-
-#define APP_NAME L"Pixiple"
-#define APP_DESCRIPTION APP_NAME L" similar image finder"
-#define APP_RELEASE 5
-
-#define APP_ICON 101
+#pragma once
+
+#define APP_NAME L"Pixiple"
+#define APP_DESCRIPTION APP_NAME L" similar image finder"
+#define APP_RELEASE 5
+
+#define APP_ICON 101
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "shared/com.h"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <ShlObj.h>
+
+class Window;
+
+// Progress bar (pane 0), centred text (pane 1) and Cancel button (pane 2)
+// of scan(), process() and reopen().
+void add_progress_panes(Window& window, const std::wstring& text);
+
+std::vector<std::filesystem::path> scan(Window& window, const std::vector<ComPtr<IShellItem>>& shell_items);
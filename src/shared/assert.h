@@ -4,6 +4,8 @@
 
 #ifdef NDEBUG
 	#define assert(condition) ((void)0)
-#else
+#elif defined(_MSC_VER)
 	#define assert(condition) (void)((!!(condition)) || (__debugbreak(), 0))
+#else
+	#define assert(condition) (void)((!!(condition)) || (__builtin_trap(), 0))
 #endif
@@ -1,3 +1,3 @@
-#pragma once
-
-void tests();
+#pragma once
+
+void tests();